@@ -31,96 +31,458 @@
   http://www.satcompetition.org/2009/format-benchmarks2009.html
 
   code example:
-    CnfReader r("test.cnf");                                       // read file "test.cnf" and run solver
-    if (r.solve()) std::cout <<   "SATISFIABLE" << std::endl;      // print result
+    CnfReader r("test.cnf");                                       // read file "test.cnf"
+    if (r.solve()) std::cout <<   "SATISFIABLE" << std::endl;      // run solver and print result
     else           std::cout << "UNSATISFIABLE" << std::endl;
     std::cout << "variable 1 is " << std::boolalpha << r.query(1); // query variable (true or false)
 
-  Note: This wrapper deliberately does not expose the add() functions.
-        Thus the SAT problem cannot be modified after reading.
-        The solver starts right away in the constructor, solve() just returns its result.
+  If you need more control then CnfParser streams all clauses into anything with an add(const int*, unsigned int)
+  function, such as MicroSAT or CnfWriter:
+    CnfParser p("test.cnf");                                       // open file "test.cnf" and read its header
+    MicroSAT s(p.getNumVars(), p.getMemoryEstimate());             // create a solver
+    p.parse(s);                                                    // and feed it with all clauses
+
+  Binary files written by CnfWriter::writeBinary are recognized by their magic bytes "MSB1" and parsed
+  much faster than text files (the format is described in cnfwriter.h).
+
+  Compressed files (gzip, bzip2, xz) are recognized by their magic bytes. They are decompressed on-the-fly
+  by the external programs gzip, bzip2 or xz (must be installed) which run in parallel to the parser.
+
+  Note: CnfReader's constructor only parses the file, the solver starts when solve() is called for the first time.
+        Additional clauses and assumptions are forwarded to the solver.
+        A CnfParser can be used only once, but its clauses can be stored in a CnfWriter and copied into several sinks.
 */
 
 #include "microsat-cpp.h"
 #include <string>
-#include <fstream>
 #include <vector>
+#include <cstdio>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#endif
 
-// CNF file reader wrapper for microsat-cpp
-// note: there are no checks whether the number of variabes or number of clauses
-//       specified in the file header actually match the parsed clauses
-class CnfReader
+// DIMACS CNF file parser, sends all clauses to a sink
+// note: literals must not exceed the number of variables specified in the file header,
+//       but there is no check whether the number of clauses actually matches the parsed clauses
+class CnfParser
 {
 private:
-  MicroSAT*    m_solver;       // microsat-cpp solver
-  bool         m_satisfiable;  // result of solve()
   unsigned int m_nVars;        // number of variables (straight from file header)
   unsigned int m_nClauses;     // number of clauses   (straight from file header)
+  unsigned int m_estimate;     // estimated size of the clause database
+  bool         m_binary;       // true if binary file format (see cnfwriter.h)
+  unsigned long long m_nLiterals; // binary file format: literals not parsed yet (starts with the file header's value)
+
+  // the file is read in large blocks and parsed by a simple hand-written scanner
+  enum { BlockSize = 1 << 20 };
+  FILE*             m_file;    // input file
+  bool              m_pipe;    // true if m_file is the output of a decompressor, false if a regular file
+  std::vector<char> m_block;   // current block of the input file
+  size_t            m_pos;     // first unprocessed byte of the current block
+  size_t            m_size;    // number of valid bytes in the current block
+
+  // return next byte but don't consume it, -1 if end-of-file
+  int peek()
+  {
+    if (m_pos == m_size)
+    {
+      // load next block
+      m_pos  = 0;
+      m_size = fread(&m_block[0], 1, m_block.size(), m_file);
+      if (m_size == 0)
+        return -1;
+    }
+    return (unsigned char) m_block[m_pos];
+  }
+
+  // open file, compressed files are piped through an external decompressor
+  void open(const std::string& filename)
+  {
+    m_file = fopen(filename.c_str(), "rb");
+    if (!m_file)
+      throw "file not found";
+
+    // look for magic bytes
+    unsigned char magic[6] = { 0 };
+    size_t numRead = fread(magic, 1, sizeof(magic), m_file);
+    const char* decompressor = 0;
+    if (numRead >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+      decompressor = "gzip";
+    if (numRead >= 3 && magic[0] == 'B'  && magic[1] == 'Z' && magic[2] == 'h')
+      decompressor = "bzip2";
+    if (numRead >= 6 && magic[0] == 0xFD && magic[1] == '7' && magic[2] == 'z' &&
+                        magic[3] == 'X'  && magic[4] == 'Z' && magic[5] == 0x00)
+      decompressor = "xz";
+
+    // uncompressed: just rewind
+    if (!decompressor)
+    {
+      fseek(m_file, 0, SEEK_SET);
+      return;
+    }
+    fclose(m_file);
+
+    // decompress to stdout, the pipe's buffer is filled while the parser is running
+    std::string command = decompressor;
+#ifdef _WIN32
+    command += " -dc \"" + filename + "\"";
+    m_file = _popen(command.c_str(), "rb");
+#else
+    // escape single quotes
+    command += " -dc '";
+    for (size_t i = 0; i < filename.size(); i++)
+      if (filename[i] == '\'')
+        command += "'\\''";
+      else
+        command += filename[i];
+    command += "'";
+    m_file = popen(command.c_str(), "r");
+#endif
+    if (!m_file)
+      throw "failed to start decompressor";
+    m_pipe = true;
+  }
+
+  // close file or pipe, return false if the decompressor failed (e.g. a truncated file or it isn't installed)
+  bool close()
+  {
+    if (!m_file)
+      return true;
+    int status = 0;
+#ifdef _WIN32
+    if (m_pipe)
+      status = _pclose(m_file);
+#else
+    if (m_pipe)
+    {
+      status = pclose(m_file);
+      // the parser may stop early (e.g. invalid data), then the decompressor is killed by SIGPIPE
+      if (status != -1 && WIFSIGNALED(status) && WTERMSIG(status) == SIGPIPE)
+        status = 0;
+    }
+#endif
+    else
+      fclose(m_file);
+    m_file = 0;
+    return status == 0;
+  }
+
+  // close file and throw an exception, a failed decompressor is more important than the parser's error message
+  void fail(const char* error)
+  {
+    if (!close())
+      throw "decompression failed";
+    throw error;
+  }
+
+  // skip whitespaces and comment lines, return next byte (-1 if end-of-file)
+  int skip(bool comments = true)
+  {
+    int c = peek();
+    while (true)
+    {
+      // whitespaces
+      while (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+      {
+        m_pos++;
+        c = peek();
+      }
+
+      // comments are terminated by a newline
+      if (c != 'c' || !comments)
+        return c;
+      while (c != '\n' && c >= 0)
+      {
+        m_pos++;
+        c = peek();
+      }
+    }
+  }
+
+  // parse a word (used only for the file header, thus "cnf" is not a comment)
+  std::string word()
+  {
+    std::string result;
+    int c = skip(false);
+    while (c > ' ')
+    {
+      result += (char) c;
+      m_pos++;
+      c = peek();
+    }
+    return result;
+  }
+
+  // parse a varint, return false if end-of-file
+  bool varint(unsigned long long& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      int c = peek();
+      if (c < 0)
+        return false;
+      m_pos++;
+
+      value |= (unsigned long long)(c & 0x7F) << shift;
+      if (c < 0x80)
+        return true;
+    }
+    return false;
+  }
+
+  // parse a signed integer, return false if end-of-file or invalid data (e.g. '%' at the end of SATLIB files)
+  bool number(int& value)
+  {
+    int c = skip();
+    bool negative = (c == '-');
+    if (negative)
+    {
+      m_pos++;
+      c = peek();
+    }
+    if (c < '0' || c > '9')
+      return false;
+
+    unsigned int x = 0;
+    do
+    {
+      // reject everything above INT_MAX
+      if (x > (0x7FFFFFFFU - (c - '0')) / 10)
+        fail("number too large");
+      x = 10 * x + (c - '0');
+      m_pos++;
+      c = peek();
+    } while (c >= '0' && c <= '9');
+
+    value = negative ? -(int)x : +(int)x;
+    return true;
+  }
 
 public:
-  // read CNF file and run solver
-  explicit CnfReader(const std::string& filename, unsigned int mem_max = 1 << 20)
-  : m_solver(0),
-    m_satisfiable(false),
-    m_nVars(0),
-    m_nClauses(0)
+  // open CNF file and read its header
+  explicit CnfParser(const std::string& filename)
+  : m_nVars(0),
+    m_nClauses(0),
+    m_estimate(0),
+    m_binary(false),
+    m_nLiterals(0),
+    m_file(0),
+    m_pipe(false),
+    m_block(BlockSize),
+    m_pos(0),
+    m_size(0)
   {
     // open file
-    std::ifstream f(filename.c_str(), std::ifstream::in);
-    if (!f)
-      throw "file not found";
+    open(filename);
+
+    // determine file size (to estimate the memory consumption, unknown for compressed files)
+    unsigned long long fileSize = 0;
+    if (!m_pipe && fseek(m_file, 0, SEEK_END) == 0)
+    {
+      long size = ftell(m_file);
+      if (size > 0)
+        fileSize = size;
+      fseek(m_file, 0, SEEK_SET);
+    }
 
-    // skip comments
-    while (f.good() && f.peek() == 'c')
+    // binary file header: number of variables, clauses and literals
+    if (peek() == 'M')
     {
-      std::string line;
-      std::getline(f, line);
+      const char* magic = "MSB1";
+      for (int i = 0; i < 4; i++, m_pos++)
+        if (peek() != magic[i])
+          fail("invalid file marker");
+
+      unsigned long long nVars = 0, nClauses = 0, nLiterals = 0;
+      if (!varint(nVars) || !varint(nClauses) || !varint(nLiterals) ||
+          nVars == 0 || nVars > 0x3FFFFFFF || nClauses == 0 || nClauses > 0xFFFFFFFF)
+        fail("invalid number of elements");
+      m_nVars    = (unsigned int) nVars;
+      m_nClauses = (unsigned int) nClauses;
+      m_nLiterals = nLiterals;
+      m_binary   = true;
+
+      // exact size of the clause database
+      unsigned long long estimate = 3ULL * m_nClauses + nLiterals;
+      m_estimate = estimate < 0x7FFFFFFF ? (unsigned int) estimate : 0x7FFFFFFF;
+      return;
     }
 
     // file header: contains number of variables (and clauses)
-    std::string headerId, format;
-    f >> headerId >> format >> m_nVars >> m_nClauses;
-    if (headerId != "p" || format != "cnf")
-      throw "invalid file marker";
-    if (m_nVars == 0 || m_nClauses == 0)
-      throw "invalid number of elements";
+    int nVars = 0, nClauses = 0;
+    if (skip() != 'p' || word() != "p" || word() != "cnf")
+      fail("invalid file marker");
+    if (!number(nVars) || !number(nClauses) || nVars <= 0 || nClauses <= 0)
+      fail("invalid number of elements");
+    m_nVars    = nVars;
+    m_nClauses = nClauses;
 
-    // create solver
-    m_solver = new MicroSAT(m_nVars, mem_max);
+    // pre-size the clause database: each clause needs 3 integers plus its literals
+    // (assume 4 bytes per literal in the file, e.g. "123 "; the database still grows if needed)
+    unsigned long long estimate = 3ULL * m_nClauses + fileSize / 4;
+    m_estimate = estimate < 0x7FFFFFFF ? (unsigned int) estimate : 0x7FFFFFFF;
+  }
+
+  // close file
+  virtual ~CnfParser() { close(); }
+
+  // send all clauses to sink (via sink.add(const int*, unsigned int) ), return number of clauses
+  template <typename Sink>
+  unsigned int parse(Sink& sink)
+  {
+    unsigned int numClauses = 0;
 
-    // add clauses
     std::vector<int> clause;
     clause.reserve(m_nVars);
-    while (f.good())
+
+    // binary file
+    if (m_binary)
     {
-      // read literals one-by-one
-      int next;
-      while (f >> next)
+      for (; m_file && numClauses < m_nClauses; numClauses++)
       {
-        // 0/zero symbolized end of clause
-        if (next == 0)
-          break;
+        unsigned long long size;
+        // a clause may contain repeated literals, but the file can't have more literals than its header says
+        // (e.g. a corrupt clause size must not allocate huge amounts of memory)
+        if (!varint(size) || size > m_nLiterals)
+          fail("invalid clause");
+        m_nLiterals -= size;
 
+        // literals are delta-encoded, see cnfwriter.h
+        clause.resize((size_t) size);
+        unsigned int previous = 0;
+        for (size_t i = 0; i < clause.size(); i++)
+        {
+          unsigned long long delta;
+          if (!varint(delta))
+            fail("unexpected end of file");
+          unsigned int zigzag = (unsigned int) delta;
+          previous += (zigzag >> 1) ^ (0U - (zigzag & 1));
+          int var = (int)(previous >> 1);
+          if (var == 0 || var > (int) m_nVars)
+            fail("invalid literal");
+          clause[i] = (previous & 1) ? -var : +var;
+        }
+
+        if (!clause.empty())
+          sink.add(clause.data(), (unsigned int) clause.size());
+      }
+
+      if (!close())
+        throw "decompression failed";
+      return numClauses;
+    }
+
+    // text file
+    int next;
+    while (m_file && number(next))
+    {
+      // 0/zero symbolized end of clause
+      if (next != 0)
+      {
+        if (next > (int) m_nVars || next < -(int) m_nVars)
+          fail("invalid literal");
         clause.push_back(next);
+        continue;
       }
 
       // add clause
       if (!clause.empty())
-        m_solver->add(clause);
+      {
+        sink.add(clause.data(), (unsigned int) clause.size());
+        numClauses++;
+      }
 
       // re-use the container
       clause.clear();
     }
+    // last clause may lack its terminating zero
+    if (!clause.empty())
+    {
+      sink.add(clause.data(), (unsigned int) clause.size());
+      numClauses++;
+    }
 
-    // run solver
-    m_satisfiable = m_solver->solve();
+    // a file can be parsed only once (a truncated compressed file is detected only now)
+    if (!close())
+      throw "decompression failed";
+    return numClauses;
+  }
+
+  // number of variables
+  unsigned int getNumVars()        const { return m_nVars; }
+  // number of clauses
+  unsigned int getNumClauses()     const { return m_nClauses; }
+  // estimated size of the clause database (second parameter of MicroSAT's constructor)
+  unsigned int getMemoryEstimate() const { return m_estimate; }
+};
+
+
+// CNF file reader wrapper for microsat-cpp
+class CnfReader
+{
+private:
+  MicroSAT*    m_solver;       // microsat-cpp solver
+  bool         m_solved;       // true if m_satisfiable is up-to-date
+  bool         m_satisfiable;  // result of solve()
+  unsigned int m_nVars;        // number of variables (straight from file header)
+  unsigned int m_nClauses;     // number of clauses   (straight from file header)
+
+public:
+  // read CNF file
+  explicit CnfReader(const std::string& filename, unsigned int mem_max = 1 << 20)
+  : m_solver(0),
+    m_solved(false),
+    m_satisfiable(false),
+    m_nVars(0),
+    m_nClauses(0)
+  {
+    // open file
+    CnfParser parser(filename);
+    m_nVars    = parser.getNumVars();
+    m_nClauses = parser.getNumClauses();
+
+    // create solver
+    unsigned int estimate = parser.getMemoryEstimate();
+    m_solver = new MicroSAT(m_nVars, estimate > mem_max ? estimate : mem_max);
+
+    // add clauses (the destructor isn't called if the constructor throws)
+    try
+    {
+      parser.parse(*m_solver);
+    }
+    catch (...)
+    {
+      delete m_solver;
+      throw;
+    }
   }
 
   // deallocate memory
   virtual ~CnfReader() { delete m_solver; }
 
-  // determine satisfiability
-  bool solve() const   { return m_satisfiable; }
+  // add a unit or a clause (same as MicroSAT)
+  bool add(int var) { m_solved = false; return m_solver->add(var); }
+  bool add(const int* in, unsigned int size) { m_solved = false; return m_solver->add(in, size); }
+  template <typename Container>
+  bool add(const Container& v) { m_solved = false; return m_solver->add(v); }
+
+  // determine satisfiability (runs the solver only once unless new clauses were added)
+  bool solve()
+  {
+    if (!m_solved)
+      m_satisfiable = m_solver->solve();
+    m_solved = true;
+    return m_satisfiable;
+  }
+  // determine satisfiability under temporary assumptions (runs the solver each time)
+  template <typename Container>
+  bool solve(const Container& assumptions)
+  {
+    m_solved = false;
+    return m_solver->solve(assumptions);
+  }
 
   // return solution of a single variable
   bool query(unsigned int var) const { return m_solver ? m_solver->query(var) : false; }
@@ -33,9 +33,24 @@
 
   code example:
     CnfWriter s(2);                                                // set number of variables
+    s.reserve(2, 3);                                               // optional: expected number of clauses and literals
     s.add(-2);                                                     // add a unit
     auto clause = { -1, +2 }; s.add(clause);                       // add a clause
     s.write("test.cnf");                                           // write file
+    s.writeBinary("test.cnfb");                                    // or a binary file (much faster to read again)
+    s.writeIncremental("test.icnf", cubes);                        // or an iCNF file with cubes (see cubeandconquer.h)
+
+  All stored clauses can be sent to any other solver:
+    MicroSAT solver(s.getNumVars());                               // create a solver
+    s.copyTo(solver);                                              // and feed it with all clauses
+
+  Binary file format (read by CnfReader / CnfParser, too):
+  - 4 bytes magic "MSB1"
+  - varints: number of variables, number of clauses, total number of literals
+  - each clause: varint number of literals, followed by its literals
+  - a literal x is mapped to u = 2*abs(x) + (x < 0), each u is stored as the zigzag-encoded difference
+    to the previous u of the same clause (the first one relative to zero)
+  - varints are little-endian base-128: 7 bits per byte, the highest bit is set if more bytes follow
 */
 
 #include <string>
@@ -46,46 +61,151 @@
 class CnfWriter
 {
   unsigned int m_nVars;            // number of variables
-  typedef std::vector<int> Clause;
-  std::vector<Clause> m_clauses;   // clauses
+  size_t       m_nClauses;         // number of clauses
+  std::vector<int> m_literals;     // all clauses, each terminated by a zero (same layout as MicroSAT's m_DB)
+
+  // output is assembled in large chunks
+  enum { BufferSize = 1 << 20 };
+
+  // append a varint (7 bits per byte, highest bit set if more bytes follow)
+  static void varint(std::string& buffer, unsigned long long x) {
+    while (x >= 0x80) {
+      buffer += (char)(x | 0x80);
+      x >>= 7; }
+    buffer += (char) x; }
+
+  // append a signed decimal number
+  static void decimal(std::string& buffer, int x) {
+    char digits[12];
+    char* pos = digits + sizeof(digits);
+    unsigned int value = x < 0 ? 0U - x : x;
+    do { *--pos = (char)('0' + value % 10); value /= 10; } while (value > 0);
+    if (x < 0) *--pos = '-';
+    buffer.append(pos, digits + sizeof(digits) - pos); }
+
+  // write buffer to file if it's almost full
+  static void flush(std::ofstream& f, std::string& buffer, bool force = false) {
+    if (buffer.size() < BufferSize && !force) return;
+    f.write(buffer.data(), buffer.size());
+    buffer.clear(); }
+
+  // copy a clause into the arena, reject clauses containing a zero
+  template <typename Iterator>
+  bool append (Iterator first, Iterator last) {
+    size_t start = m_literals.size();
+    for (; first != last; ++first) {
+      if (*first == 0) { m_literals.resize(start); return false; }
+      m_literals.push_back(*first); }
+    if (m_literals.size() == start) return false;
+    m_literals.push_back(0);
+    m_nClauses++;
+    return true; }
+
+  // write all clauses as text, zeros are already in place
+  void writeClauses(std::ofstream& f, std::string& buffer) const {
+    for (size_t i = 0; i < m_literals.size(); i++) {
+      decimal(buffer, m_literals[i]);
+      buffer += m_literals[i] == 0 ? '\n' : ' ';
+      flush(f, buffer); } }
 
 public:
   // initialize data structures
   explicit CnfWriter(unsigned int nVars, unsigned int mem_max = 0)
-  : m_nVars(nVars), m_clauses()
+  : m_nVars(nVars), m_nClauses(0), m_literals()
   {
     // parameter mem_max isn't needed at all but exists to be compatible to microsat-cpp
+    (void) mem_max;
   }
 
+  // pre-allocate memory for the expected number of clauses and literals (optional)
+  void reserve(size_t numClauses, size_t numLiterals) { m_literals.reserve(numClauses + numLiterals); }
+
   // set a unit
-  void add (int var) { m_clauses.push_back( { var } ); }
+  bool add (int var) { return add (&var, 1); }
 
   // define a clause
   bool add (const int* in, unsigned int size) {
     if (in == 0 || size == 0) return false;
-    m_clauses.push_back (Clause(in, in+size));
-    return true; }
+    return append (in, in + size); }
 
   // same as above, but a convenience function for STL containers
   template <typename Container>
-  bool add (const Container& v) {
-    Clause clause(v.begin(), v.end());
-    return add (clause.data(), clause.size()); }
+  bool add (const Container& v) { return append (v.begin(), v.end()); }
 
   // write CNF file
-  bool write(const std::string& filename) {
-    std::ofstream f(filename.c_str());
+  bool write(const std::string& filename) const {
+    std::ofstream f(filename.c_str(), std::ios::binary);
+    if (!f) return false;
+    std::string buffer = "c converted by microsat-cpp's CnfWriter\np cnf ";
+    decimal(buffer, m_nVars);
+    buffer += ' ';
+    decimal(buffer, (int) m_nClauses);
+    buffer += '\n';
+
+    writeClauses(f, buffer);
+    flush(f, buffer, true);
+    return (bool) f.flush(); }
+
+  // write iCNF file: all clauses followed by one line per cube ("a" + its literals), e.g. for cube-and-conquer
+  // cubes is a container of containers of ints (such as std::vector<std::vector<int>> )
+  template <typename Cubes>
+  bool writeIncremental(const std::string& filename, const Cubes& cubes) const {
+    std::ofstream f(filename.c_str(), std::ios::binary);
+    if (!f) return false;
+    std::string buffer = "c converted by microsat-cpp's CnfWriter\np inccnf\n";
+
+    writeClauses(f, buffer);
+    for (typename Cubes::const_iterator cube = cubes.begin(); cube != cubes.end(); cube++) {
+      buffer += 'a';
+      for (typename Cubes::value_type::const_iterator lit = cube->begin(); lit != cube->end(); lit++) {
+        buffer += ' ';
+        decimal(buffer, (int) *lit); }
+      buffer += " 0\n";
+      flush(f, buffer); }
+    flush(f, buffer, true);
+    return (bool) f.flush(); }
+
+  // write binary CNF file (see format description at the top of this file)
+  bool writeBinary(const std::string& filename) const {
+    std::ofstream f(filename.c_str(), std::ios::binary);
     if (!f) return false;
-    f << "c converted by microsat-cpp's CnfWriter" << std::endl
-      << "p cnf " << m_nVars << " " << m_clauses.size() << std::endl;
+
+    // header
+    std::string buffer = "MSB1";
+    varint(buffer, m_nVars);
+    varint(buffer, m_nClauses);
+    varint(buffer, m_literals.size() - m_nClauses);
 
     // write clauses
-    for (size_t i = 0; i < m_clauses.size(); i++) {
-      for (size_t j = 0; j < m_clauses[i].size(); j++)
-        f << m_clauses[i][j] << " ";
-      // always a trailing zero
-      f << "0" << std::endl; }
-    return true; }
+    for (const int* clause = m_literals.data(); clause != m_literals.data() + m_literals.size(); ) {
+      const int* end = clause;
+      while (*end) end++;
+      varint(buffer, end - clause);
+      unsigned int previous = 0;
+      for (; clause != end; clause++) {
+        unsigned int current = *clause < 0 ? 2U * -*clause + 1 : 2U * *clause;
+        unsigned int delta   = current - previous;  // wraps around if negative
+        varint(buffer, (delta << 1) ^ (unsigned int)((int)delta >> 31));
+        previous = current; }
+      clause++; // skip zero
+      flush(f, buffer); }
+    flush(f, buffer, true);
+    return (bool) f.flush(); }
+
+  // send all clauses to another sink (e.g. MicroSAT or another CnfWriter), return number of clauses
+  template <typename Sink>
+  unsigned int copyTo(Sink& sink) const {
+    for (const int* clause = m_literals.data(); clause != m_literals.data() + m_literals.size(); ) {
+      const int* end = clause;
+      while (*end) end++;
+      sink.add(clause, (unsigned int)(end - clause));
+      clause = end + 1; }
+    return (unsigned int) m_nClauses; }
+
+  // number of variables
+  unsigned int getNumVars()    const { return m_nVars; }
+  // number of clauses
+  unsigned int getNumClauses() const { return (unsigned int) m_nClauses; }
 
   // the following functions exist pure for compatibility reasons
   bool solve() const { return false; }
@@ -0,0 +1,446 @@
+#pragma once
+
+/*************************************************************[cubeandconquer.h]***
+
+  The MIT License
+
+  Copyright (c) 2020 Stephan Brumme
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*************************************************************************************
+
+  Cube-and-conquer: a lookahead splits a problem into many independent cubes (sets of assumptions),
+  each cube is solved by microsat-cpp's incremental assumption API.
+  The problem is satisfiable if at least one cube is satisfiable.
+
+  CubeGenerator only creates the cubes, e.g. to distribute them across a cluster:
+    CubeGenerator g(numVars);                                      // set number of variables
+    g.add(...);                                                    // add clauses (or CnfWriter::copyTo / CnfParser::parse)
+    auto cubes = g.generate(10);                                   // split 10 times => at most 1024 cubes
+    writer.writeIncremental("problem.icnf", cubes);                // iCNF file, see CnfWriter
+
+  CubeAndConquer has the same API as microsat-cpp (except for enumerate and setLemmaRetention):
+    CubeAndConquer s(numVars);                                     // set number of variables (one solver per core)
+    s.add(...);                                                    // add clauses
+    if (s.solve()) std::cout << s.query(1);                        // generate cubes and solve them in parallel
+
+  The lookahead branches on the variable whose both polarities shrink the most clauses (product of both scores),
+  only the most frequent unassigned variables are examined. Literals which lead to a conflict are failed literals:
+  their negation is assigned, too. Cubes refuted by the lookahead itself are dropped.
+
+  Note: each thread of CubeAndConquer has its own copy of all clauses. Compile with -pthread.
+*/
+
+#include "microsat-cpp.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// split a problem into cubes using lookahead
+class CubeGenerator
+{
+public:
+  typedef std::vector<int>  Cube;
+  typedef std::vector<Cube> Cubes;
+
+  // look ahead on at most that many variables per split
+  enum { MaxCandidates = 64 };
+
+  // initialize data structures, mem_max exists only for compatibility with microsat-cpp
+  explicit CubeGenerator(unsigned int nVars, unsigned int mem_max = 0)
+  : m_nVars(nVars),
+    m_literals(),
+    m_start(),
+    m_occurrences(2 * nVars + 1),
+    m_value(nVars + 1, 0),
+    m_trail(),
+    m_decisions(),
+    m_cubes(),
+    m_order()
+  {
+    (void) mem_max;
+  }
+
+  // set a unit
+  bool add(int var) { return add(&var, 1); }
+
+  // define a clause
+  bool add(const int* in, unsigned int size) { return in != 0 && append(in, in + size); }
+
+  // same as above, but a convenience function for STL containers
+  template <typename Container>
+  bool add(const Container& v) { return append(v.begin(), v.end()); }
+
+  // split at most depth times, unsatisfiable if there are no cubes at all
+  Cubes generate(unsigned int depth)
+  {
+    m_cubes.clear();
+    m_decisions.clear();
+    undo(0);
+
+    // examine frequent variables first
+    m_order.clear();
+    for (unsigned int var = 1; var <= m_nVars; var++)
+      m_order.push_back(var);
+    std::stable_sort(m_order.begin(), m_order.end(), ByFrequency(*this));
+
+    // units of the problem
+    bool ok = true;
+    for (size_t i = 0; i < m_start.size() && ok; i++)
+      if (m_literals[m_start[i] + 1] == 0)
+        ok = enqueue(m_literals[m_start[i]]);
+    if (ok && propagate(0))
+      split(depth);
+
+    undo(0);
+    return m_cubes;
+  }
+
+  // number of variables
+  unsigned int getNumVars()    const { return m_nVars; }
+  // number of clauses
+  unsigned int getNumClauses() const { return (unsigned int) m_start.size(); }
+
+private:
+  unsigned int m_nVars;                           // number of variables
+  std::vector<int> m_literals;                    // all clauses, each terminated by a zero
+  std::vector<unsigned int> m_start;              // offset of each clause in m_literals
+  std::vector<std::vector<unsigned int> > m_occurrences; // clauses containing a literal (index: literal + m_nVars)
+  std::vector<signed char> m_value;               // +1 = true, -1 = false, 0 = unassigned
+  std::vector<int> m_trail;                       // all true literals
+  Cube  m_decisions;                              // literals of the current cube
+  Cubes m_cubes;                                  // result of generate()
+  std::vector<unsigned int> m_order;              // variables sorted by their number of occurrences
+
+  // sort variables by the product of their positive and negative occurrences
+  struct ByFrequency
+  {
+    const CubeGenerator& generator;
+    explicit ByFrequency(const CubeGenerator& g) : generator(g) {}
+    unsigned long long score(unsigned int var) const
+    {
+      return (generator.occurrences(+(int)var).size() + 1ULL) * (generator.occurrences(-(int)var).size() + 1ULL);
+    }
+    bool operator()(unsigned int a, unsigned int b) const { return score(a) > score(b); }
+  };
+
+  const std::vector<unsigned int>& occurrences(int lit) const { return m_occurrences[lit + (int)m_nVars]; }
+
+  // copy a clause, reject clauses containing a zero or an invalid variable
+  template <typename Iterator>
+  bool append(Iterator first, Iterator last)
+  {
+    size_t start = m_literals.size();
+    for (; first != last; ++first)
+    {
+      int lit = (int) *first;
+      if (lit == 0 || lit > (int)m_nVars || -lit > (int)m_nVars)
+      {
+        m_literals.resize(start);
+        return false;
+      }
+      m_literals.push_back(lit);
+    }
+    if (m_literals.size() == start)
+      return false;
+    m_literals.push_back(0);
+
+    unsigned int clause = (unsigned int) m_start.size();
+    m_start.push_back((unsigned int) start);
+    for (size_t i = start; m_literals[i] != 0; i++)
+      m_occurrences[m_literals[i] + m_nVars].push_back(clause);
+    return true;
+  }
+
+  int value(int lit) const { return lit > 0 ? m_value[lit] : -m_value[-lit]; }
+
+  // make lit true, return false if it's already false
+  bool enqueue(int lit)
+  {
+    if (value(lit) != 0)
+      return value(lit) > 0;
+    m_value[lit > 0 ? lit : -lit] = lit > 0 ? +1 : -1;
+    m_trail.push_back(lit);
+    return true;
+  }
+
+  // unassign all literals after the first size literals of the trail
+  void undo(size_t size)
+  {
+    while (m_trail.size() > size)
+    {
+      int lit = m_trail.back();
+      m_value[lit > 0 ? lit : -lit] = 0;
+      m_trail.pop_back();
+    }
+  }
+
+  // propagate all literals of the trail starting at position next, return false on conflict
+  // score (optional) counts the clauses shrunk by those assignments, clauses shrunk to binaries count more
+  bool propagate(size_t next, unsigned int* score = 0)
+  {
+    for (; next < m_trail.size(); next++)
+    {
+      const std::vector<unsigned int>& clauses = occurrences(-m_trail[next]);
+      for (size_t i = 0; i < clauses.size(); i++)
+      {
+        const int* clause = &m_literals[m_start[clauses[i]]];
+        int unassigned = 0, last = 0;
+        bool satisfied = false;
+        for (; *clause != 0 && !satisfied; clause++)
+          if (value(*clause) == 0)
+          {
+            unassigned++;
+            last = *clause;
+          }
+          else
+            satisfied = value(*clause) > 0;
+
+        if (satisfied)
+          continue;
+        if (unassigned == 0)
+          return false;
+        if (unassigned == 1)
+          enqueue(last);
+        else if (score)
+          *score += unassigned == 2 ? 5 : 1;
+      }
+    }
+    return true;
+  }
+
+  // assign lit and propagate, return 0 on conflict or the score plus one (trail is restored)
+  unsigned int lookahead(int lit)
+  {
+    size_t size = m_trail.size();
+    unsigned int score = 1;
+    enqueue(lit);
+    if (!propagate(size, &score))
+      score = 0;
+    undo(size);
+    return score;
+  }
+
+  // choose a variable by lookahead and split on it, emit cubes at the leaves
+  void split(unsigned int depth)
+  {
+    if (depth == 0)
+    {
+      m_cubes.push_back(m_decisions);
+      return;
+    }
+
+    int best = 0;
+    unsigned long long bestScore = 0;
+    unsigned int examined = 0;
+    bool failed = false;
+    for (size_t i = 0; i < m_order.size() && examined < MaxCandidates; i++)
+    {
+      int var = (int) m_order[i];
+      if (value(var) != 0)
+        continue;
+      examined++;
+
+      unsigned int positive = lookahead(+var);
+      unsigned int negative = lookahead(-var);
+      // failed literals: the opposite polarity is implied
+      if (positive == 0 || negative == 0)
+      {
+        size_t size = m_trail.size();
+        if (positive == 0 && negative == 0)
+          return; // no cube left
+        enqueue(positive == 0 ? -var : +var);
+        if (!propagate(size))
+          return;
+        failed = true;
+        continue;
+      }
+
+      unsigned long long score = (unsigned long long) positive * negative;
+      if (score > bestScore)
+      {
+        best      = var;
+        bestScore = score;
+      }
+    }
+
+    // scores are outdated after failed literals (the caller undoes all assignments anyway)
+    if (failed)
+    {
+      split(depth);
+      return;
+    }
+
+    // all variables assigned: single cube
+    if (best == 0)
+    {
+      m_cubes.push_back(m_decisions);
+      return;
+    }
+
+    // try both polarities
+    for (int polarity = +1; polarity >= -1; polarity -= 2)
+    {
+      size_t size = m_trail.size();
+      m_decisions.push_back(polarity * best);
+      enqueue(polarity * best);
+      if (propagate(size))
+        split(depth - 1);
+      undo(size);
+      m_decisions.pop_back();
+    }
+  }
+};
+
+
+// split a problem into cubes and solve them on multiple threads, compatible with microsat-cpp
+class CubeAndConquer
+{
+  std::vector<MicroSAT*> m_solvers;   // one per thread
+  CubeGenerator          m_generator; // creates the cubes
+  std::atomic<bool>      m_stop;      // true if a solver found a solution (or failed)
+  int                    m_winner;    // index of the solver which found a solution, -1 if none
+  int                    m_status;    // result of the last call of solve()
+  unsigned int           m_nCubes;    // number of cubes of the last call of solve()
+
+  // terminate callback of all solvers
+  static int isStopped(void* state) { return ((std::atomic<bool>*) state)->load() ? 1 : 0; }
+
+  // disable copying
+  CubeAndConquer(const CubeAndConquer&);
+  CubeAndConquer& operator=(const CubeAndConquer&);
+
+public:
+  // split at most 8 times by default (at most 256 cubes)
+  enum { DefaultDepth = 8 };
+
+  // initialize all solvers, numThreads = 0 => one solver per core
+  explicit CubeAndConquer(unsigned int nVars, unsigned int mem_max = 1 << 20, unsigned int numThreads = 0)
+  : m_solvers(),
+    m_generator(nVars),
+    m_stop(false),
+    m_winner(-1),
+    m_status(MicroSAT::UNKNOWN),
+    m_nCubes(0)
+  {
+    if (numThreads == 0)
+      numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+      numThreads = 1;
+
+    for (unsigned int i = 0; i < numThreads; i++)
+    {
+      m_solvers.push_back(new MicroSAT(nVars, mem_max));
+      m_solvers.back()->setTerminate(&m_stop, &isStopped);
+    }
+  }
+
+  // deallocate memory
+  virtual ~CubeAndConquer()
+  {
+    for (size_t i = 0; i < m_solvers.size(); i++)
+      delete m_solvers[i];
+  }
+
+  // add a unit
+  bool add(int var) { return add(&var, 1); }
+
+  // define a clause, it is copied to all solvers
+  bool add(const int* in, unsigned int size)
+  {
+    bool result = m_generator.add(in, size);
+    for (size_t i = 0; i < m_solvers.size(); i++)
+      result &= m_solvers[i]->add(in, size);
+    return result;
+  }
+
+  // same as above, but a convenience function for STL containers
+  template <typename Container>
+  bool add(const Container& v)
+  {
+    std::vector<int> clause(v.begin(), v.end());
+    return add(clause.data(), (unsigned int) clause.size());
+  }
+
+  // split into cubes and solve them
+  bool solve(unsigned int depth = DefaultDepth)
+  {
+    m_stop   = false;
+    m_winner = -1;
+    m_status = MicroSAT::UNKNOWN;
+
+    CubeGenerator::Cubes cubes = m_generator.generate(depth);
+    m_nCubes = (unsigned int) cubes.size();
+
+    // each thread takes the next unsolved cube
+    std::atomic<unsigned int> next(0);
+    std::atomic<int> winner(-1);
+    const char* error = 0;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < m_solvers.size(); i++)
+      threads.push_back(std::thread([this, i, &cubes, &next, &winner, &error]()
+      {
+        try
+        {
+          while (!m_stop)
+          {
+            unsigned int current = next++;
+            if (current >= cubes.size())
+              break;
+            m_solvers[i]->solve(cubes[current]);
+            int none = -1;
+            if (m_solvers[i]->getStatus() == MicroSAT::SATISFIABLE && winner.compare_exchange_strong(none, (int)i))
+              m_stop = true;
+          }
+        }
+        catch (const char* e)
+        {
+          // e.g. out of memory: give up
+          int none = -1;
+          if (winner.compare_exchange_strong(none, -2))
+            error = e;
+          m_stop = true;
+        }
+      }));
+    for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+
+    if (winner == -2)
+      throw error;
+
+    // unsatisfiable if all cubes are unsatisfiable
+    m_winner = winner;
+    m_status = m_winner >= 0 ? MicroSAT::SATISFIABLE : MicroSAT::UNSATISFIABLE;
+    return m_status == MicroSAT::SATISFIABLE;
+  }
+
+  // result of the last call of solve()
+  MicroSAT::Status getStatus() const { return (MicroSAT::Status) m_status; }
+
+  // return solution of a single variable
+  bool query(unsigned int var) const { return m_winner >= 0 ? m_solvers[m_winner]->query(var) : false; }
+
+  // number of solvers running in parallel
+  unsigned int getNumThreads() const { return (unsigned int) m_solvers.size(); }
+
+  // number of cubes of the last call of solve()
+  unsigned int getNumCubes()   const { return m_nCubes; }
+};
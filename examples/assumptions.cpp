@@ -0,0 +1,104 @@
+// //////////////////////////////////////////////////////////
+// assumptions.cpp
+// Copyright (c) 2020 Stephan Brumme
+// see https://create.stephan-brumme.com/microsat-cpp/
+//
+// Incremental solving with assumptions and failed assumptions (getFailed / failed),
+// including a few corner cases: a single variable, contradictory assumptions
+// and a cardinality constraint added after an unsatisfiable call.
+// Returns exit code 1 if any check fails.
+//
+// The code relies on the microsat-cpp library:
+// https://github.com/stbrumme/microsat-cpp/
+// Which in turn was derived from MicroSAT:
+// https://github.com/marijnheule/microsat/
+// (both are MIT licensed as well as this assumptions.cpp file)
+//
+// "MIT License":
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// compile:
+// g++ assumptions.cpp -o assumptions -std=c++11
+
+#include "../microsat-cpp.h"
+#include <iostream>
+#include <vector>
+
+// count failed checks
+unsigned int errors = 0;
+
+void check(bool ok, const char* description)
+{
+  std::cout << (ok ? "ok     " : "FAILED ") << description << std::endl;
+  if (!ok)
+    errors++;
+}
+
+// number of failed assumptions of the last call of solve()
+unsigned int numFailed(const MicroSAT& s)
+{
+  unsigned int size;
+  s.getFailed(size);
+  return size;
+}
+
+// a single variable: contradictory assumptions in both orders, the solver must recover afterwards
+void singleVariable(MicroSAT& s, const char* name)
+{
+  std::cout << name << std::endl;
+  std::vector<int> both    = { +1, -1 };
+  std::vector<int> reverse = { -1, +1 };
+  std::vector<int> pos     = { +1 };
+  std::vector<int> neg     = { -1 };
+
+  check(!s.solve(both),                                  "{+1,-1} is unsatisfiable");
+  check(numFailed(s) == 2 && s.failed(+1) && s.failed(-1), "  and both assumptions failed");
+  check( s.solve(neg) && !s.query(1),                    "{-1} is satisfiable afterwards");
+  check(!s.solve(reverse),                               "{-1,+1} is unsatisfiable");
+  check(numFailed(s) == 2 && s.failed(+1) && s.failed(-1), "  and both assumptions failed");
+  check( s.solve(pos) &&  s.query(1),                    "{+1} is satisfiable afterwards");
+  check( s.solve(),                                      "satisfiable without assumptions");
+  check(numFailed(s) == 0,                               "  and no assumption failed");
+}
+
+int main()
+{
+  MicroSAT one(1);
+  singleVariable(one, "MicroSAT s(1)");
+
+  MicroSAT grown;
+  grown.newVar();
+  singleVariable(grown, "MicroSAT s; s.newVar()");
+
+  // x1 => x2, x2 => x3
+  std::cout << "implications" << std::endl;
+  MicroSAT chain(4);
+  auto clause1 = { -1, +2 }; chain.add(clause1);
+  auto clause2 = { -2, +3 }; chain.add(clause2);
+  std::vector<int> assumptions = { +4, +1, -3 };
+  check(!chain.solve(assumptions),                       "{+4,+1,-3} is unsatisfiable");
+  check(numFailed(chain) == 2 && chain.failed(+1) && chain.failed(-3) && !chain.failed(+4), "  core is {+1,-3}");
+
+  // the core must survive until the next call of solve()
+  std::vector<int> atMostOne = { 1, 2, 3, 4 };
+  chain.addAtMostOne(atMostOne);
+  check(numFailed(chain) == 2 && chain.failed(+1) && chain.failed(-3), "  core is kept by addAtMostOne");
+  check( chain.solve() && !chain.query(1),               "satisfiable without assumptions");
+
+  return errors > 0 ? 1 : 0;
+}
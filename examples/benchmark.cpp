@@ -0,0 +1,240 @@
+// //////////////////////////////////////////////////////////
+// benchmark.cpp
+// Copyright (c) 2020 Stephan Brumme
+// see https://create.stephan-brumme.com/microsat-cpp/
+//
+// Measures MicroSAT's performance on a set of CNF files and compares it with an earlier run,
+// e.g. the puzzles written by the other examples (microdoku1.cnf, microhitori.cnf, ...)
+// and/or any DIMACS files (text, binary or compressed, see cnfreader.h):
+//   ./benchmark --save baseline.json *.cnf       // run all files and store the results
+//   ./benchmark --baseline baseline.json *.cnf   // run again and report regressions (exit code 1)
+//
+// The code relies on the microsat-cpp library:
+// https://github.com/stbrumme/microsat-cpp/
+// Which in turn was derived from MicroSAT:
+// https://github.com/marijnheule/microsat/
+// (both are MIT licensed as well as this benchmark.cpp file)
+//
+// "MIT License":
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// compile:
+// g++ benchmark.cpp -o benchmark -std=c++11 -O3
+
+#include "../cnfreader.h"
+#include "../cnfwriter.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// result of a single instance
+struct Result
+{
+  std::string name;
+  std::string status;       // SAT, UNSAT or UNKNOWN
+  double      seconds;      // fastest of all repetitions (clauses are loaded before the timer starts)
+  unsigned long long conflicts;
+  unsigned long long propagations;
+  unsigned long long peakBytes; // clause database's high-water mark plus the watch arena
+};
+
+
+// solve a single file (each repetition uses a new solver)
+Result run(const std::string& filename, unsigned int repeat)
+{
+  // parse only once
+  CnfParser parser(filename);
+  CnfWriter clauses(parser.getNumVars());
+  parser.parse(clauses);
+
+  Result result = { filename, "UNKNOWN", 0, 0, 0, 0 };
+  for (unsigned int i = 0; i < repeat; i++)
+  {
+    MicroSAT s(parser.getNumVars(), parser.getMemoryEstimate());
+    clauses.copyTo(s);
+
+    auto start = std::chrono::steady_clock::now();
+    auto sat   = s.solve();
+    auto stop  = std::chrono::steady_clock::now();
+
+    auto seconds = std::chrono::duration<double>(stop - start).count();
+    if (i == 0 || seconds < result.seconds)
+      result.seconds = seconds;
+
+    // the solver is deterministic, all repetitions have the same statistics
+    auto stats = s.getStats();
+    result.status       = s.getStatus() == MicroSAT::UNKNOWN ? "UNKNOWN" : sat ? "SAT" : "UNSAT";
+    result.conflicts    = stats.conflicts;
+    result.propagations = stats.propagations;
+    result.peakBytes    = (stats.peakMemory + (unsigned long long)stats.pairs) * sizeof(int);
+  }
+  return result;
+}
+
+
+// extract a value from a line written by save(), e.g. value(line, "seconds") => "0.0123"
+std::string value(const std::string& line, const std::string& key)
+{
+  auto pos = line.find("\"" + key + "\":");
+  if (pos == std::string::npos)
+    return "";
+  pos += key.size() + 3;
+  while (pos < line.size() && line[pos] == ' ')
+    pos++;
+
+  // string or number
+  if (pos < line.size() && line[pos] == '"')
+    return line.substr(pos + 1, line.find('"', pos + 1) - pos - 1);
+  auto end = line.find_first_of(",}", pos);
+  return line.substr(pos, end - pos);
+}
+
+
+// store results as JSON, one instance per line
+void save(const std::string& filename, const std::vector<Result>& results)
+{
+  std::ofstream f(filename);
+  f << "{ \"instances\": [" << std::endl;
+  for (size_t i = 0; i < results.size(); i++)
+    f << "  { \"name\": \""       << results[i].name         << "\""
+      <<   ", \"status\": \""     << results[i].status       << "\""
+      <<   ", \"seconds\": "      << results[i].seconds
+      <<   ", \"conflicts\": "    << results[i].conflicts
+      <<   ", \"propagations\": " << results[i].propagations
+      <<   ", \"peakBytes\": "    << results[i].peakBytes
+      << " }" << (i + 1 < results.size() ? "," : "") << std::endl;
+  f << "] }" << std::endl;
+}
+
+
+// read a file written by save(), instances are identified by their name
+std::map<std::string, Result> load(const std::string& filename)
+{
+  std::map<std::string, Result> results;
+  std::ifstream f(filename);
+  if (!f)
+    throw "cannot open baseline";
+
+  std::string line;
+  while (std::getline(f, line))
+  {
+    auto name = value(line, "name");
+    if (name.empty())
+      continue;
+
+    Result& r = results[name];
+    r.name         = name;
+    r.status       = value(line, "status");
+    r.seconds      = std::stod  (value(line, "seconds"));
+    r.conflicts    = std::stoull(value(line, "conflicts"));
+    r.propagations = std::stoull(value(line, "propagations"));
+    r.peakBytes    = std::stoull(value(line, "peakBytes"));
+  }
+  return results;
+}
+
+
+int main(int argc, char* argv[])
+{
+  // parse command-line
+  std::string baseline, output;
+  unsigned int repeat    = 3;    // take the fastest of three runs
+  double       tolerance = 0.10; // report instances which are more than 10% slower than the baseline
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if      (arg == "--baseline"  && i + 1 < argc) baseline  = argv[++i];
+    else if (arg == "--save"      && i + 1 < argc) output    = argv[++i];
+    else if (arg == "--repeat"    && i + 1 < argc) repeat    = std::stoi(argv[++i]);
+    else if (arg == "--tolerance" && i + 1 < argc) tolerance = std::stoi(argv[++i]) / 100.0;
+    else files.push_back(arg);
+  }
+  if (files.empty() || repeat == 0)
+  {
+    std::cerr << "syntax: ./benchmark [--baseline old.json] [--save new.json] [--repeat 3] [--tolerance 10] files.cnf ..." << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    std::map<std::string, Result> before;
+    if (!baseline.empty())
+      before = load(baseline);
+
+    // run all instances
+    std::vector<Result> results;
+    double total = 0;
+    auto   regressions = 0;
+    std::cout << "c  seconds  conflicts/s propagations/s  peak memory  status   instance" << std::endl;
+    for (auto& filename : files)
+    {
+      auto r = run(filename, repeat);
+      results.push_back(r);
+      total += r.seconds;
+
+      auto perSecond = [&r](unsigned long long x) { return r.seconds > 0 ? (unsigned long long)(x / r.seconds) : 0ULL; };
+      std::cout << "c " << std::fixed << std::setprecision(4) << std::setw(8) << r.seconds
+                << std::setw(13) << perSecond(r.conflicts)
+                << std::setw(15) << perSecond(r.propagations)
+                << std::setw(11) << (r.peakBytes >> 10) << " kB"
+                << "  " << std::setw(7) << std::left << r.status << std::right << "  " << r.name;
+
+      // compare with baseline
+      auto old = before.find(r.name);
+      if (old != before.end())
+      {
+        auto& o = old->second;
+        if (o.status != r.status)
+        {
+          std::cout << "  WRONG (was " << o.status << ")";
+          regressions++;
+        }
+        else if (r.seconds > o.seconds * (1 + tolerance) && r.seconds - o.seconds > 0.001) // ignore tiny instances
+        {
+          std::cout << "  SLOWER (" << std::setprecision(0) << 100 * (r.seconds / o.seconds - 1) << "%)";
+          regressions++;
+        }
+        else if (r.seconds < o.seconds / (1 + tolerance))
+          std::cout << "  faster (" << std::setprecision(0) << 100 * (1 - r.seconds / o.seconds) << "%)";
+        if (o.conflicts != r.conflicts)
+          std::cout << "  conflicts " << o.conflicts << " => " << r.conflicts; // search behavior changed
+      }
+      std::cout << std::endl;
+    }
+
+    std::cout << "c total " << std::setprecision(4) << total << " seconds for " << results.size() << " instance(s)";
+    if (!baseline.empty())
+      std::cout << ", " << regressions << " regression(s)";
+    std::cout << std::endl;
+
+    if (!output.empty())
+      save(output, results);
+
+    return regressions > 0 ? 1 : 0;
+  }
+  catch (const char* e)
+  {
+    std::cerr << "error: " << e << std::endl;
+    return 1;
+  }
+}
@@ -47,49 +47,44 @@ int main(int argc, char* argv[])
 
   auto filename = argv[1];
 
-  // initial memory size is 1 million temporaries
+  // initial memory size is 1 million temporaries (grows automatically if needed)
   auto memLimit = 1 << 20;
   if (argc > 2)
     memLimit = std::stoi(argv[2]);
 
-  // repeat if out-of-memory exception is thrown
-  bool done = false;
-  while (!done)
-    try
-    {
-      // parse file and run solver
-      CnfReader c(filename, memLimit);
+  try
+  {
+    // parse file (the solver runs when solve() is called)
+    CnfReader c(filename, memLimit);
 
-      // show some statistics
-      std::cout << "c microsat-cpp" << std::endl
-                << "c solving " << filename << std::endl
-                << "c " << c.getNumVars() << " variables, " << c.getNumClauses() << " clauses" << std::endl
-                << (c.solve() ? "s SATISFIABLE" : "s UNSATISFIABLE") << std::endl;
+    // show some statistics
+    std::cout << "c microsat-cpp" << std::endl
+              << "c solving " << filename << std::endl
+              << "c " << c.getNumVars() << " variables, " << c.getNumClauses() << " clauses" << std::endl
+              << (c.solve() ? "s SATISFIABLE" : "s UNSATISFIABLE") << std::endl;
 
-      // print model
-      std::string line = "v ";
-      for (auto i = 1; i <= (int)c.getNumVars(); i++)
+    // print model
+    std::string line = "v ";
+    for (auto i = 1; i <= (int)c.getNumVars(); i++)
+    {
+      // avoid too long lines
+      if (line.size() > 75)
       {
-        // avoid too long lines
-        if (line.size() > 75)
-        {
-          std::cout << line << std::endl;
-          line = "v ";
-        }
-
-        line += std::to_string(c.query(i) ? +i : -i) + " ";
+        std::cout << line << std::endl;
+        line = "v ";
       }
-      // don't forget the last line and terminate with a single zero
-      std::cout << line << std::endl << "v 0" << std::endl;
 
-      // we're done
-      done = true;
-    }
-    catch (const char* e)
-    {
-      // out of memory, allocate twice as much in next iteration
-      memLimit *= 2;
+      line += std::to_string(c.query(i) ? +i : -i) + " ";
     }
+    // don't forget the last line and terminate with a single zero
+    std::cout << line << std::endl << "v 0" << std::endl;
+  }
+  catch (const char* e)
+  {
+    // invalid file
+    std::cerr << "error: " << e << std::endl;
+    return 1;
+  }
 
   return 0;
 }
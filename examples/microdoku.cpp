@@ -403,95 +403,71 @@ int main(int argc, char* argv[])
         }
 
     // --------------- SAT solver ---------------
-    auto numSolutions = 0;
-    auto satMemory = 150*1000; // 150000 temporaries are enough for most sudokus (majority needs around 60000 but a few require 200000+)
-    while (true) // there are breaks inside the loop
-    {
-      try
-      {
-        // initialize
-        MicroSAT s(numVars, satMemory);
-
-        if (verbose)
-          std::cout << "c " << numVars << " variables and " << clauses.size() << " clauses" << std::endl;
-
-        // set all known variables
-        for (auto v : knownVars) // v is an integer
-          s.add(v);
-        // add all clauses
-        for (auto& c : clauses)  // c is std::vector
-          s.add(c);
+    auto satMemory = 60*1000; // initial number of temporaries: majority of sudokus needs around 60000, the solver grows its memory if needed
+    MicroSAT s(numVars, satMemory);
 
-        // run the SAT solver
-        auto satisfiable = s.solve();
-        // oops, failed ?
-        if (!satisfiable)
-          break;
-
-        numSolutions++;
-
-        // extract solution
-        for (auto y = 1; y <= size; y++)
-          for (auto x = 1; x <= size; x++)
-            for (auto digit = 1; digit <= size; digit++)
-              // only one variable at x,y can be true
-              if (s.query(p.id(x, y, digit)))
-              {
-                p.set(x, y, digit);
-                break;
-              }
-
-        // display that solution
-        if (verbose)
-        {
-          std::cout << "c solution " << numSolutions << ":" << std::endl;
-          p.display();
-        }
+    if (verbose)
+      std::cout << "c " << numVars << " variables and " << clauses.size() << " clauses" << std::endl;
 
-        // optional: CNF output
-        if (createCnfFiles)
-        {
-          // pretty much the same as above but using class CnfWriter instead of MicroSAT
-          CnfWriter writer(numVars);
-          for (auto v : knownVars)
-            writer.add(v);
-          for (auto& c : clauses)
-            writer.add(c);
-
-          auto filename = "microdoku" + std::to_string(numProblems) + ".cnf";
-          writer.write(filename);
-        }
+    // set all known variables
+    for (auto v : knownVars) // v is an integer
+      s.add(v);
+    // add all clauses
+    for (auto& c : clauses)  // c is std::vector
+      s.add(c);
 
-        // no need for further search ?
-        if (!findAllSolutions)
-          break;
+    // optional: CNF output
+    if (createCnfFiles)
+    {
+      // pretty much the same as above but using class CnfWriter instead of MicroSAT
+      CnfWriter writer(numVars);
+      for (auto v : knownVars)
+        writer.add(v);
+      for (auto& c : clauses)
+        writer.add(c);
+
+      auto filename = "microdoku" + std::to_string(numProblems) + ".cnf";
+      writer.write(filename);
+    }
 
-        // prepare next iteration: create a new clause that excludes the current solution
-        Clause reject;
-        for (auto y = 1; y <= size; y++)
-          for (auto x = 1; x <= size; x++)
-            for (auto digit = 1; digit <= size; digit++)
+    // run the SAT solver: each solution is passed to the lambda and then excluded from further searches
+    // (an empty projection means that solutions are distinguished by all variables)
+    auto numShown     = 0;
+    auto numSolutions = s.enumerate([&](const MicroSAT& solution)
+    {
+      // extract solution
+      for (auto y = 1; y <= size; y++)
+        for (auto x = 1; x <= size; x++)
+          for (auto digit = 1; digit <= size; digit++)
+            // only one variable at x,y can be true
+            if (solution.query(p.id(x, y, digit)))
             {
-              auto id = p.id(x, y, digit);
-              if (s.query(id))
-              {
-                reject.push_back(-id);
-                break;
-              }
+              p.set(x, y, digit);
+              break;
             }
-        clauses.push_back(reject);
-      }
-      catch (const char* e)
+
+      // display that solution
+      if (verbose)
       {
-        // out of memory, restart with larger allocation
-        satMemory += 50000;
-        std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
+        std::cout << "c solution " << ++numShown << ":" << std::endl;
+        p.display();
       }
-    }
+
+      // keep going
+      return true;
+    }, Clause(), findAllSolutions ? 0 : 1); // no need for further search if only one solution is requested
 
     // print current problem's results
     std::cout << "c found " << numSolutions << " solution(s)" << std::endl;
 
+    // solver statistics, e.g. to choose satMemory
+    if (verbose)
+    {
+      auto stats = s.getStats();
+      std::cout << "c " << stats.conflicts << " conflicts, " << stats.decisions << " decisions, "
+                << stats.propagations << " propagations, peak memory " << stats.peakMemory << " temporaries" << std::endl;
+    }
+
     // update statistics
     if (numSolutions == 0)
       numFailed++;
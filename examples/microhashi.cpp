@@ -449,164 +449,155 @@ int main()
     clauses = validOnly;
   }
 
-  auto satMemory = 12 * clauses.size(); // estimated memory consumption, will be increased if needed
+  auto satMemory = 12 * clauses.size(); // estimated memory consumption, the solver grows its memory if needed
   auto iterations = 0;
   auto solutions  = 0;
   bool findAllSolutions = true;
   while (true)
   {
-    try
-    {
-      // initialize solver
-      MicroSAT s(numVars, satMemory);
-      for (auto& c : clauses)
-        s.add(c);
+    // initialize solver
+    MicroSAT s(numVars, satMemory);
+    for (auto& c : clauses)
+      s.add(c);
 
-      // run solver
-      auto ok = s.solve();
+    // run solver
+    auto ok = s.solve();
 
-      iterations++;
-      std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
+    iterations++;
+    std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
 
-      if (!ok)
-      {
-        std::cout << "c failed to find more solutions" << std::endl;
-        break;
-      }
+    if (!ok)
+    {
+      std::cout << "c failed to find more solutions" << std::endl;
+      break;
+    }
 
-      // all numbers must be connected to each other
-      // first, collect all numbers
-      std::set<std::pair<int,int>> numbers;
-      for (auto y = 0; y < height; y++)
-        for (auto x = 0; x < width; x++)
-          if (get(x,y) != ' ')
-            numbers.insert({ x,y });
-
-      // then start a simple iterative search
-      std::vector<std::pair<int,int>> todo = { *numbers.begin() };
-      Clause exclude;
-      while (!todo.empty())
-      {
-        auto current = todo.back();
-        todo.pop_back();
+    // all numbers must be connected to each other
+    // first, collect all numbers
+    std::set<std::pair<int,int>> numbers;
+    for (auto y = 0; y < height; y++)
+      for (auto x = 0; x < width; x++)
+        if (get(x,y) != ' ')
+          numbers.insert({ x,y });
+
+    // then start a simple iterative search
+    std::vector<std::pair<int,int>> todo = { *numbers.begin() };
+    Clause exclude;
+    while (!todo.empty())
+    {
+      auto current = todo.back();
+      todo.pop_back();
 
-        // ignore already processed numbers
-        if (numbers.count(current) == 0)
-          continue;
+      // ignore already processed numbers
+      if (numbers.count(current) == 0)
+        continue;
 
-        // mark as processed
-        numbers.erase(current);
+      // mark as processed
+      numbers.erase(current);
 
-        auto x = current.first;
-        auto y = current.second;
+      auto x = current.first;
+      auto y = current.second;
 
-        // walk along a north-bound bridge
-        if (idBridge(x,y,North) != NoId && s.query(idBridge(x,y,North)))
-        {
-          for (auto scan = y - 1; scan >= 0; scan--)
-            if (get(x, scan) != ' ')
-            {
-              todo.push_back({ x, scan });
-              break;
-            }
-
-          exclude.push_back(-idBridge(x,y,North));
-          if (s.query(idDouble(x,y,North)))
-            exclude.push_back(-idDouble(x,y,North));
-        }
-        // walk along a south-bound bridge
-        if (idBridge(x,y,South) != NoId && s.query(idBridge(x,y,South)))
-        {
-          for (auto scan = y + 1; scan < height; scan++)
-            if (get(x, scan) != ' ')
-            {
-              todo.push_back({ x, scan });
-              break;
-            }
-
-          exclude.push_back(-idBridge(x,y,South));
-          if (s.query(idDouble(x,y,South)))
-            exclude.push_back(-idDouble(x,y,South));
-        }
-        // walk along a west-bound bridge
-        if (idBridge(x,y,West) != NoId && s.query(idBridge(x,y,West)))
-        {
-          for (auto scan = x - 1; scan >= 0; scan--)
-            if (get(scan, y) != ' ')
-            {
-              todo.push_back({ scan, y });
-              break;
-            }
-
-          exclude.push_back(-idBridge(x,y,West));
-          if (s.query(idDouble(x,y,West)))
-            exclude.push_back(-idDouble(x,y,West));
-        }
-        // walk along a east-bound bridge
-        if (idBridge(x,y,East) != NoId && s.query(idBridge(x,y,East)))
-        {
-          for (auto scan = x + 1; scan < width; scan++)
-            if (get(scan, y) != ' ')
-            {
-              todo.push_back({ scan, y });
-              break;
-            }
-
-          exclude.push_back(-idBridge(x,y,East));
-          if (s.query(idDouble(x,y,East)))
-            exclude.push_back(-idDouble(x,y,East));
-        }
+      // walk along a north-bound bridge
+      if (idBridge(x,y,North) != NoId && s.query(idBridge(x,y,North)))
+      {
+        for (auto scan = y - 1; scan >= 0; scan--)
+          if (get(x, scan) != ' ')
+          {
+            todo.push_back({ x, scan });
+            break;
+          }
+
+        exclude.push_back(-idBridge(x,y,North));
+        if (s.query(idDouble(x,y,North)))
+          exclude.push_back(-idDouble(x,y,North));
       }
+      // walk along a south-bound bridge
+      if (idBridge(x,y,South) != NoId && s.query(idBridge(x,y,South)))
+      {
+        for (auto scan = y + 1; scan < height; scan++)
+          if (get(x, scan) != ' ')
+          {
+            todo.push_back({ x, scan });
+            break;
+          }
 
-      // yes, valid solution
-      if (numbers.empty())
+        exclude.push_back(-idBridge(x,y,South));
+        if (s.query(idDouble(x,y,South)))
+          exclude.push_back(-idDouble(x,y,South));
+      }
+      // walk along a west-bound bridge
+      if (idBridge(x,y,West) != NoId && s.query(idBridge(x,y,West)))
       {
-        // display
-        show(s);
+        for (auto scan = x - 1; scan >= 0; scan--)
+          if (get(scan, y) != ' ')
+          {
+            todo.push_back({ scan, y });
+            break;
+          }
 
-        solutions++;
-        std::cout << "c solution " << solutions << " found !" << std::endl;
+        exclude.push_back(-idBridge(x,y,West));
+        if (s.query(idDouble(x,y,West)))
+          exclude.push_back(-idDouble(x,y,West));
+      }
+      // walk along a east-bound bridge
+      if (idBridge(x,y,East) != NoId && s.query(idBridge(x,y,East)))
+      {
+        for (auto scan = x + 1; scan < width; scan++)
+          if (get(scan, y) != ' ')
+          {
+            todo.push_back({ scan, y });
+            break;
+          }
 
-        // show first solution
-        if (solutions == 1)
-        {
-          std::cout << "v ";
-          for (auto i = 1; i <= numVars; i++)
-            std::cout << (s.query(i) ? +i : -i) << " ";
-          std::cout << "0" << std::endl;
-        }
+        exclude.push_back(-idBridge(x,y,East));
+        if (s.query(idDouble(x,y,East)))
+          exclude.push_back(-idDouble(x,y,East));
+      }
+    }
 
-        // write CNF file
-        if (solutions == 1)
-        {
-          CnfWriter writer(numVars);
-          for (auto& c : clauses)
-            writer.add(c);
-          writer.write("microhashi" + std::to_string(solutions) + ".cnf");
-        }
+    // yes, valid solution
+    if (numbers.empty())
+    {
+      // display
+      show(s);
 
-        // done ?
-        if (!findAllSolutions)
-          break;
-      }
-      else
+      solutions++;
+      std::cout << "c solution " << solutions << " found !" << std::endl;
+
+      // show first solution
+      if (solutions == 1)
       {
-        if (showIntermediateSteps)
-          show(s);
+        std::cout << "v ";
+        for (auto i = 1; i <= numVars; i++)
+          std::cout << (s.query(i) ? +i : -i) << " ";
+        std::cout << "0" << std::endl;
+      }
 
-        // nope, need another iteration
-        std::cout << "c current candidate has no fully connected graph, need to restart" << std::endl;
+      // write CNF file
+      if (solutions == 1)
+      {
+        CnfWriter writer(numVars);
+        for (auto& c : clauses)
+          writer.add(c);
+        writer.write("microhashi" + std::to_string(solutions) + ".cnf");
       }
 
-      // exclude current board in future analysis
-      clauses.push_back(exclude);
+      // done ?
+      if (!findAllSolutions)
+        break;
     }
-    catch (const char* e)
+    else
     {
-      // out of memory, restart with larger allocation
-      satMemory += 10000;
-      std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
+      if (showIntermediateSteps)
+        show(s);
+
+      // nope, need another iteration
+      std::cout << "c current candidate has no fully connected graph, need to restart" << std::endl;
     }
+
+    // exclude current board in future analysis
+    clauses.push_back(exclude);
   }
 
   // wow, we're done !
@@ -159,139 +159,132 @@ int main()
           clauses.push_back({ +id(x,scan), +id(x,y) });
     }
 
-  auto satMemory  = 10*1000; // 10,000 temporaries are sufficient for the given problems (even the big ones)
+  // --------------- SAT solver ---------------
+
+  auto satMemory  = 10*1000; // 10,000 temporaries are sufficient for the given problems (the solver grows its memory if needed)
+  auto numVars    = width * height;
+  MicroSAT s(numVars, satMemory);
+
+  // add clauses
+  for (auto& c : clauses)
+    s.add(c);
+
   auto solutions  = 0;
   auto iterations = 1;
   while (true)
   {
-    try
-    {
-      // --------------- SAT solver ---------------
+    std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses" << std::endl;
 
-      auto numVars = width * height;
-      MicroSAT s(numVars, satMemory);
+    // run the SAT solver
+    if (!s.solve())
+      break;
 
-      // add clauses
-      for (auto& c : clauses)
-        s.add(c);
-
-      std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses" << std::endl;
+    // --------------- check solution ---------------
 
-      // run the SAT solver
-      if (!s.solve())
-        break;
+    // all non-erased cells need to be connected
+    // => it's quite hard to convert this requirement to CNF
+    //    therefore I allow the SAT solver to create solutions
+    //    violating this rule, check this rule in separate code,
+    //    exclude failed solutions and re-run the solver
 
-      // --------------- check solution ---------------
+    // keep track of processed cells
+    std::vector<char> processed(width * height + 1, false);
 
-      // all non-erased cells need to be connected
-      // => it's quite hard to convert this requirement to CNF
-      //    therefore I allow the SAT solver to create solutions
-      //    violating this rule, check this rule in separate code,
-      //    exclude failed solutions and re-run the solver
+    // iterative floodfill algorithm, starts in the upper-left corner
+    // see https://en.wikipedia.org/wiki/Flood_fill
+    std::vector<std::pair<short, short>> todo = { { 0,0 } };
+    // upper-right corner erased ?
+    if (s.query(id(0,0)))
+      todo.front() = { 1,0 }; // replace with its right neighbor
 
-      // keep track of processed cells
-      std::vector<char> processed(width * height + 1, false);
-
-      // iterative floodfill algorithm, starts in the upper-left corner
-      // see https://en.wikipedia.org/wiki/Flood_fill
-      std::vector<std::pair<short, short>> todo = { { 0,0 } };
-      // upper-right corner erased ?
-      if (s.query(id(0,0)))
-        todo.front() = { 1,0 }; // replace with its right neighbor
+    while (!todo.empty())
+    {
+      // pick a cell
+      auto next = todo.back();
+      todo.pop_back();
+
+      // get its coordinates
+      auto x = next.first;
+      auto y = next.second;
+
+      // out of bounds ?
+      if (x < 0 || x >= width ||
+          y < 0 || y >= height)
+        continue;
+
+      // skip erased cells
+      if (s.query(id(x,y)))
+        continue;
+
+      // already processed ?
+      if (processed[id(x,y)])
+        continue;
+
+      // mark cell as processed
+      processed[id(x,y)] = true;
+
+      // continue with its neighbors, too
+      todo.push_back({ x-1,y });
+      todo.push_back({ x+1,y });
+      todo.push_back({ x,y-1 });
+      todo.push_back({ x,y+1 });
+    }
 
-      while (!todo.empty())
+    // verify and print solution
+    std::cout << "c candidate " << iterations << ":" << std::endl;
+    auto scannedAll = true;
+    for (auto y = 0; y < height; y++)
+    {
+      std::cout << "c ";
+      for (auto x = 0; x < width; x++)
       {
-        // pick a cell
-        auto next = todo.back();
-        todo.pop_back();
-
-        // get its coordinates
-        auto x = next.first;
-        auto y = next.second;
-
-        // out of bounds ?
-        if (x < 0 || x >= width ||
-            y < 0 || y >= height)
-          continue;
-
-        // skip erased cells
-        if (s.query(id(x,y)))
-          continue;
-
-        // already processed ?
-        if (processed[id(x,y)])
-          continue;
+        // look for a non-erased cell that wasn't processed by my flood-fill code
+        auto isErased = s.query(id(x,y));
+        scannedAll &= isErased || processed[id(x,y)];
+
+        // and let's print the cell, too
+        if (isErased)
+          std::cout << ".";
+        else
+          std::cout << get(x,y);
+      }
+      std::cout << std::endl;
+    }
 
-        // mark cell as processed
-        processed[id(x,y)] = true;
+    // if we reached all cells then the candidate is a solution
+    if (scannedAll)
+    {
+      std::cout << "c found solution !" << std::endl;
+      solutions++;
 
-        // continue with its neighbors, too
-        todo.push_back({ x-1,y });
-        todo.push_back({ x+1,y });
-        todo.push_back({ x,y-1 });
-        todo.push_back({ x,y+1 });
-      }
+      // show solution
+      std::cout << "v ";
+      for (auto i = 1; i <= numVars; i++)
+        std::cout << (s.query(i) ? +i : -i) << " ";
+      std::cout << "0" << std::endl;
 
-      // verify and print solution
-      std::cout << "c candidate " << iterations << ":" << std::endl;
-      auto scannedAll = true;
-      for (auto y = 0; y < height; y++)
-      {
-        std::cout << "c ";
-        for (auto x = 0; x < width; x++)
-        {
-          // look for a non-erased cell that wasn't processed by my flood-fill code
-          auto isErased = s.query(id(x,y));
-          scannedAll &= isErased || processed[id(x,y)];
-
-          // and let's print the cell, too
-          if (isErased)
-            std::cout << ".";
-          else
-            std::cout << get(x,y);
-        }
-        std::cout << std::endl;
-      }
+      // create CNF file
+      CnfWriter writer(numVars);
+      for (auto& c : clauses)
+        writer.add(c);
+      writer.write("microhitori.cnf");
 
-      // if we reached all cells then the candidate is a solution
-      if (scannedAll)
-      {
-        std::cout << "c found solution !" << std::endl;
-        solutions++;
-
-        // show solution
-        std::cout << "v ";
-        for (auto i = 1; i <= numVars; i++)
-          std::cout << (s.query(i) ? +i : -i) << " ";
-        std::cout << "0" << std::endl;
-
-        // create CNF file
-        CnfWriter writer(numVars);
-        for (auto& c : clauses)
-          writer.add(c);
-        writer.write("microhitori.cnf");
-
-        break;
-      }
+      break;
+    }
 
-      // --------------- exclude solution ---------------
+    // --------------- exclude solution ---------------
 
-      // look for erased cells and disallow their combination
-      Clause exclude;
-      for (auto y = 0; y < height; y++)
-        for (auto x = 0; x < width; x++)
-          if (s.query(id(x,y)))
-            exclude.push_back( -id(x,y) );
+    // look for erased cells and disallow their combination
+    Clause exclude;
+    for (auto y = 0; y < height; y++)
+      for (auto x = 0; x < width; x++)
+        if (s.query(id(x,y)))
+          exclude.push_back( -id(x,y) );
 
-      clauses.push_back(std::move(exclude));
-      iterations++;
-    }
-    catch (const char* e)
-    {
-      // out of memory, restart with larger allocation
-      satMemory *= 2;
-      std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
-    }
+    // the same solver continues with one more clause (and keeps what it learned so far)
+    s.add(exclude);
+    clauses.push_back(std::move(exclude));
+    iterations++;
   }
 
   // failed
@@ -408,234 +408,227 @@ int main()
     }
 
 
-  auto satMemory = 2*1000*1000; // 2,000,000 temporaries are sufficient for the given problems
+  auto satMemory = 2*1000*1000; // 2,000,000 temporaries are sufficient for the given problems (the solver grows its memory if needed)
+
+  // --------------- SAT solver ---------------
+
+  // the same solver is used for all iterations, only new clauses will be added
+  auto numVars  = baseId;
+  MicroSAT s(numVars, satMemory);
+  size_t numAdded = 0;
 
   auto iterations = 0;
   auto solutions  = 0;
   while (true)
   {
-    try
-    {
-      // --------------- SAT solver ---------------
+    // add new clauses (in the first iteration: all clauses, later just the exclusions)
+    for (; numAdded < clauses.size(); numAdded++)
+      s.add(clauses[numAdded]);
 
-      auto numVars = baseId;
-      MicroSAT s(numVars, satMemory);
+    iterations++;
+    std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
 
-      // add clauses
-      for (auto& c : clauses)
-        s.add(c);
-
-      iterations++;
-      std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
-
-      // run the SAT solver
-      if (!s.solve())
-        break;
+    // run the SAT solver
+    if (!s.solve())
+      break;
 
-      // --------------- check solution ---------------
+    // --------------- check solution ---------------
 
-      // display candidate
-      for (auto y = 0; y < height; y++)
+    // display candidate
+    for (auto y = 0; y < height; y++)
+    {
+      std::cout << "c ";
+      for (auto x = 0; x < width; x++)
       {
-        std::cout << "c ";
-        for (auto x = 0; x < width; x++)
-        {
-          Cell current = get(x,y);
-          if (current.isBlocked)
-            std::cout << '#';
-          else if (current.rightSum > 0 || current.downSum > 0)
-            std::cout << '\\';
-          else if (current.isEmpty)
-            for (auto i = 1; i <= 9; i++)
-              if (s.query(current.baseId + i))
-                std::cout << i;
-        }
-        std::cout << std::endl;
+        Cell current = get(x,y);
+        if (current.isBlocked)
+          std::cout << '#';
+        else if (current.rightSum > 0 || current.downSum > 0)
+          std::cout << '\\';
+        else if (current.isEmpty)
+          for (auto i = 1; i <= 9; i++)
+            if (s.query(current.baseId + i))
+              std::cout << i;
       }
+      std::cout << std::endl;
+    }
 
-      // are sums fulfilled ?
-      auto numFailed = 0;
-      auto numExcluded = 0;
-      Clause exclude;
-      std::vector<char> digits;
-      for (auto y = 0; y < height; y++)
-        for (auto x = 0; x < width; x++)
-        {
-          auto current = get(x,y);
+    // are sums fulfilled ?
+    auto numFailed = 0;
+    auto numExcluded = 0;
+    Clause exclude;
+    std::vector<char> digits;
+    for (auto y = 0; y < height; y++)
+      for (auto x = 0; x < width; x++)
+      {
+        auto current = get(x,y);
 
-          // check horizontal sum
-          if (current.rightSum > 0)
-          {
-            auto sum = 0;
-            exclude.clear();
-            digits.clear();
-            for (auto scan = x + 1; scan < x + 1 + current.rightSumLength; scan++)
-              // get solved digit
-              for (auto i = 1; i <= 9; i++)
+        // check horizontal sum
+        if (current.rightSum > 0)
+        {
+          auto sum = 0;
+          exclude.clear();
+          digits.clear();
+          for (auto scan = x + 1; scan < x + 1 + current.rightSumLength; scan++)
+            // get solved digit
+            for (auto i = 1; i <= 9; i++)
+            {
+              auto id = get(scan,y).baseId + i;
+              if (s.query(id))
               {
-                auto id = get(scan,y).baseId + i;
-                if (s.query(id))
-                {
-                  // add to sum
-                  sum += i;
-                  exclude.push_back(-id);
-                  digits.push_back(i);
-                  break;
-                }
+                // add to sum
+                sum += i;
+                exclude.push_back(-id);
+                digits.push_back(i);
+                break;
               }
+            }
 
-            // mismatched sum ? exclude it
-            if (sum != current.rightSum)
+          // mismatched sum ? exclude it
+          if (sum != current.rightSum)
+          {
+            numFailed++;
+
+            // exclude all its permutations, too
+            if (excludePermutations)
             {
-              numFailed++;
+              std::sort(digits.begin(), digits.end());
 
-              // exclude all its permutations, too
-              if (excludePermutations)
+              do
               {
-                std::sort(digits.begin(), digits.end());
+                exclude.clear();
 
-                do
+                // ignore permutations that are impossible
+                bool possible = true;
+                for (auto i = 0; i < current.rightSumLength; i++)
                 {
-                  exclude.clear();
+                  auto scan = x + 1 + i;
 
-                  // ignore permutations that are impossible
-                  bool possible = true;
-                  for (auto i = 0; i < current.rightSumLength; i++)
+                  // that digit can't be there anyway ?
+                  if (!allowedCells[scan][y][digits[i]])
                   {
-                    auto scan = x + 1 + i;
-
-                    // that digit can't be there anyway ?
-                    if (!allowedCells[scan][y][digits[i]])
-                    {
-                      possible = false;
-                      break;
-                    }
-
-                    auto id = get(scan,y).baseId + digits[i];
-                    exclude.push_back(-id);
+                    possible = false;
+                    break;
                   }
 
-                  // yep, needs to be excluded
-                  if (possible)
-                  {
-                    clauses.push_back(exclude);
-                    numExcluded++;
-                  }
-                } while (std::next_permutation(digits.begin(), digits.end()));
-              }
-              else
-              {
-                clauses.push_back(exclude);
-                numExcluded++;
-              }
+                  auto id = get(scan,y).baseId + digits[i];
+                  exclude.push_back(-id);
+                }
+
+                // yep, needs to be excluded
+                if (possible)
+                {
+                  clauses.push_back(exclude);
+                  numExcluded++;
+                }
+              } while (std::next_permutation(digits.begin(), digits.end()));
+            }
+            else
+            {
+              clauses.push_back(exclude);
+              numExcluded++;
             }
           }
+        }
 
-          // check vertical sum
-          if (current.downSum > 0)
-          {
-            auto sum = 0;
+        // check vertical sum
+        if (current.downSum > 0)
+        {
+          auto sum = 0;
 
-            exclude.clear();
-            digits.clear();
+          exclude.clear();
+          digits.clear();
 
-            for (auto scan = y + 1; scan < y + 1 + current.downSumLength; scan++)
-              // get solved digit
-              for (auto i = 1; i <= 9; i++)
+          for (auto scan = y + 1; scan < y + 1 + current.downSumLength; scan++)
+            // get solved digit
+            for (auto i = 1; i <= 9; i++)
+            {
+              auto id = get(x,scan).baseId + i;
+              if (s.query(id))
               {
-                auto id = get(x,scan).baseId + i;
-                if (s.query(id))
-                {
-                  // add to sum
-                  sum += i;
-                  exclude.push_back(-id);
-                  digits.push_back(i);
-                  break;
-                }
+                // add to sum
+                sum += i;
+                exclude.push_back(-id);
+                digits.push_back(i);
+                break;
               }
+            }
+
+          // mismatched sum ? exclude it
+          if (sum != current.downSum)
+          {
+            numFailed++;
 
-            // mismatched sum ? exclude it
-            if (sum != current.downSum)
+            // exclude all its permutations, too
+            if (excludePermutations)
             {
-              numFailed++;
+              std::sort(digits.begin(), digits.end());
 
-              // exclude all its permutations, too
-              if (excludePermutations)
+              do
               {
-                std::sort(digits.begin(), digits.end());
+                exclude.clear();
 
-                do
+                // ignore permutations that are impossible
+                bool possible = true;
+                for (auto i = 0; i < current.downSumLength; i++)
                 {
-                  exclude.clear();
+                  auto scan = y + 1 + i;
 
-                  // ignore permutations that are impossible
-                  bool possible = true;
-                  for (auto i = 0; i < current.downSumLength; i++)
+                  // that digit can't be there anyway ?
+                  if (!allowedCells[x][scan][digits[i]])
                   {
-                    auto scan = y + 1 + i;
-
-                    // that digit can't be there anyway ?
-                    if (!allowedCells[x][scan][digits[i]])
-                    {
-                      possible = false;
-                      break;
-                    }
-
-                    auto id = get(x,scan).baseId + digits[i];
-                    exclude.push_back(-id);
+                    possible = false;
+                    break;
                   }
 
-                  // yep, needs to be excluded
-                  if (possible)
-                  {
-                    clauses.push_back(exclude);
-                    numExcluded++;
-                  }
-                } while (std::next_permutation(digits.begin(), digits.end()));
-              }
-              else
-              {
-                clauses.push_back(exclude);
-                numExcluded++;
-              }
+                  auto id = get(x,scan).baseId + digits[i];
+                  exclude.push_back(-id);
+                }
+
+                // yep, needs to be excluded
+                if (possible)
+                {
+                  clauses.push_back(exclude);
+                  numExcluded++;
+                }
+              } while (std::next_permutation(digits.begin(), digits.end()));
+            }
+            else
+            {
+              clauses.push_back(exclude);
+              numExcluded++;
             }
           }
         }
-
-      if (numFailed > 0)
-      {
-        std::cout << "c " << numFailed << " sum constraints violated, added " << numExcluded << " exclusions" << std::endl;
-        continue;
       }
 
-      // that's a new solution !
-      solutions++;
-      std::cout << "c solution " << solutions << " found" << std::endl;
+    if (numFailed > 0)
+    {
+      std::cout << "c " << numFailed << " sum constraints violated, added " << numExcluded << " exclusions" << std::endl;
+      continue;
+    }
 
-      if (!findAllSolutions)
-        break;
+    // that's a new solution !
+    solutions++;
+    std::cout << "c solution " << solutions << " found" << std::endl;
 
-      // try finding other solutions
-      exclude.clear();
-      for (auto y = 0; y < height; y++)
-        for (auto x = 0; x < width; x++)
-          for (auto i = 1; i <= 9; i++)
+    if (!findAllSolutions)
+      break;
+
+    // try finding other solutions
+    exclude.clear();
+    for (auto y = 0; y < height; y++)
+      for (auto x = 0; x < width; x++)
+        for (auto i = 1; i <= 9; i++)
+        {
+          auto id = get(x,y).baseId + i;
+          if (s.query(id))
           {
-            auto id = get(x,y).baseId + i;
-            if (s.query(id))
-            {
-              exclude.push_back(-id);
-              break;
-            }
+            exclude.push_back(-id);
+            break;
           }
-      clauses.push_back(exclude);
-    }
-    catch (const char* e)
-    {
-      // out of memory, restart with larger allocation
-      satMemory += 100000;
-      std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
-    }
+        }
+    clauses.push_back(exclude);
   }
 
   // failed
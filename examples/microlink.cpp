@@ -412,148 +412,139 @@ int main()
   clauses = std::move(sorted);
 
 
-  auto satMemory = 200*1000; // 200,000 temporaries are sufficient for the given problems (even the big ones)
+  auto satMemory = 200*1000; // 200,000 temporaries are sufficient for the given problems (the solver grows its memory if needed)
   auto iterations = 0;
   auto solutions  = 0;
   auto findAllSolutions = true;
   while (true)
   {
-    try
-    {
-      // initialize
-      auto numVars = numEdges + 1; // there's no variable 0
-      MicroSAT s(numVars, satMemory);
+    // initialize
+    auto numVars = numEdges + 1; // there's no variable 0
+    MicroSAT s(numVars, satMemory);
 
-      // add clauses
-      for (auto& c : clauses)
-        s.add(c);
+    // add clauses
+    for (auto& c : clauses)
+      s.add(c);
 
-      // run solver
-      auto ok = s.solve();
+    // run solver
+    auto ok = s.solve();
 
-      iterations++;
-      std::cout << "c " << numEdges << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
+    iterations++;
+    std::cout << "c " << numEdges << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
 
-      if (!ok)
-        break;
+    if (!ok)
+      break;
 
-      // check whether a single loop was formed
-      // first, let's find all cells inside a loop
-      std::set<std::pair<int, int>> inside;
-      // scan from left to right
-      // crossing the first  set edge enters the loop,
-      // crossing the second set edge leaves the loop, third enters, etc.
-      for (auto y = 0; y < height; y++)
+    // check whether a single loop was formed
+    // first, let's find all cells inside a loop
+    std::set<std::pair<int, int>> inside;
+    // scan from left to right
+    // crossing the first  set edge enters the loop,
+    // crossing the second set edge leaves the loop, third enters, etc.
+    for (auto y = 0; y < height; y++)
+    {
+      bool isInside = false;
+      for (auto x = 0; x < width; x++)
       {
-        bool isInside = false;
-        for (auto x = 0; x < width; x++)
-        {
-          // switch inside/outside
-          if (s.query(id(x,y,West)))
-            isInside = !isInside;
-          // add cell if inside
-          if (isInside)
-            inside.insert({ x,y });
-        }
+        // switch inside/outside
+        if (s.query(id(x,y,West)))
+          isInside = !isInside;
+        // add cell if inside
+        if (isInside)
+          inside.insert({ x,y });
       }
+    }
 
-      // count distinct loops
-      auto numLoops = 0;
-      while (!inside.empty())
-      {
-        numLoops++;
-        Clause loop;
-
-        // find all connected cells, start with first cell which is inside
-        std::vector<std::pair<int, int>> todo = { *inside.begin() };
-        while (!todo.empty())
-        {
-          // take a look at next cell
-          auto current = todo.back();
-          todo.pop_back();
-
-          // it needs to be a cell inside the loop
-          if (inside.count(current) == 0)
-            continue;
-
-          // processed, remove from set
-          inside.erase(current);
-
-          // check neighbors
-          auto x = current.first;
-          auto y = current.second;
-
-          todo.push_back({ x-1, y   });
-          todo.push_back({ x+1, y   });
-          todo.push_back({ x  , y-1 });
-          todo.push_back({ x  , y+1 });
-
-          // remember current cell's edges in case we have multiple loops
-          // (then we exclude all loops)
-          if (s.query(id(x,y,North))) loop.push_back(-id(x,y,North));
-          if (s.query(id(x,y,East ))) loop.push_back(-id(x,y,East ));
-          if (s.query(id(x,y,South))) loop.push_back(-id(x,y,South));
-          if (s.query(id(x,y,West ))) loop.push_back(-id(x,y,West ));
-        }
+    // count distinct loops
+    auto numLoops = 0;
+    while (!inside.empty())
+    {
+      numLoops++;
+      Clause loop;
 
-        clauses.push_back(loop);
+      // find all connected cells, start with first cell which is inside
+      std::vector<std::pair<int, int>> todo = { *inside.begin() };
+      while (!todo.empty())
+      {
+        // take a look at next cell
+        auto current = todo.back();
+        todo.pop_back();
+
+        // it needs to be a cell inside the loop
+        if (inside.count(current) == 0)
+          continue;
+
+        // processed, remove from set
+        inside.erase(current);
+
+        // check neighbors
+        auto x = current.first;
+        auto y = current.second;
+
+        todo.push_back({ x-1, y   });
+        todo.push_back({ x+1, y   });
+        todo.push_back({ x  , y-1 });
+        todo.push_back({ x  , y+1 });
+
+        // remember current cell's edges in case we have multiple loops
+        // (then we exclude all loops)
+        if (s.query(id(x,y,North))) loop.push_back(-id(x,y,North));
+        if (s.query(id(x,y,East ))) loop.push_back(-id(x,y,East ));
+        if (s.query(id(x,y,South))) loop.push_back(-id(x,y,South));
+        if (s.query(id(x,y,West ))) loop.push_back(-id(x,y,West ));
       }
 
-      // show current candidate
-      if (!findAllSolutions || numLoops == 1)
+      clauses.push_back(loop);
+    }
+
+    // show current candidate
+    if (!findAllSolutions || numLoops == 1)
+    {
+      for (auto y = 0; y < height; y++)
       {
-        for (auto y = 0; y < height; y++)
-        {
-          std::cout << "c ";
-          // north
-          for (auto x = 0; x < width; x++)
-            std::cout << " " << (s.query(id(x,y, North)) ? "-" : " ");
-          std::cout << std::endl;
-
-          std::cout << "c ";
-          // west
-          for (auto x = 0; x < width; x++)
-            std::cout << (s.query(id(x      ,y, West)) ? "|" : " ")
-                      << get(x, y);
-          // right-side: east
-          std::cout <<   (s.query(id(width-1,y, East)) ? "|" : " ")
-                    << std::endl;
-        }
-        // bottom: south
         std::cout << "c ";
+        // north
         for (auto x = 0; x < width; x++)
-          std::cout << " " << (s.query(id(x,height-1, South)) ? "-" : " ");
+          std::cout << " " << (s.query(id(x,y, North)) ? "-" : " ");
         std::cout << std::endl;
 
-        // next iteration
-        if (numLoops > 1)
-          std::cout << "c current candidate has " << numLoops << " distinct loops, need to restart" << std::endl;
+        std::cout << "c ";
+        // west
+        for (auto x = 0; x < width; x++)
+          std::cout << (s.query(id(x      ,y, West)) ? "|" : " ")
+                    << get(x, y);
+        // right-side: east
+        std::cout <<   (s.query(id(width-1,y, East)) ? "|" : " ")
+                  << std::endl;
       }
+      // bottom: south
+      std::cout << "c ";
+      for (auto x = 0; x < width; x++)
+        std::cout << " " << (s.query(id(x,height-1, South)) ? "-" : " ");
+      std::cout << std::endl;
+
+      // next iteration
+      if (numLoops > 1)
+        std::cout << "c current candidate has " << numLoops << " distinct loops, need to restart" << std::endl;
+    }
 
-      // are all inside cells connected ?
-      if (numLoops == 1)
-      {
-        solutions++;
-        std::cout << "c solution " << solutions << " found !" << std::endl;
-
-        // write CNF file
-        if (solutions == 1)
-        {
-          CnfWriter writer(numVars);
-          for (auto& c : clauses)
-            writer.add(c);
-          writer.write("microlink" + std::to_string(solutions) + ".cnf");
-        }
+    // are all inside cells connected ?
+    if (numLoops == 1)
+    {
+      solutions++;
+      std::cout << "c solution " << solutions << " found !" << std::endl;
 
-        if (!findAllSolutions)
-          break;
+      // write CNF file
+      if (solutions == 1)
+      {
+        CnfWriter writer(numVars);
+        for (auto& c : clauses)
+          writer.add(c);
+        writer.write("microlink" + std::to_string(solutions) + ".cnf");
       }
-    }
-    catch (const char* e)
-    {
-      // out of memory, restart with larger allocation
-      satMemory += 100000;
-      std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
+
+      if (!findAllSolutions)
+        break;
     }
   }
 
@@ -274,92 +274,83 @@ int main(int argc, char** argv)
   }
 
 
-  auto satMemory = 2*1000*1000; // 2,000,000 temporaries are needed for the hard problem
+  auto satMemory = 2*1000*1000; // 2,000,000 temporaries are needed for the hard problem (the solver grows its memory if needed)
   auto solutions = 0;
   while (true)
   {
-    try
-    {
-      // --------------- SAT solver ---------------
+    // --------------- SAT solver ---------------
 
-      auto numVars = size * size * size;
-      MicroSAT s(numVars, satMemory);
+    auto numVars = size * size * size;
+    MicroSAT s(numVars, satMemory);
 
-      // add clauses
-      for (auto& c : clauses)
-        s.add(c);
+    // add clauses
+    for (auto& c : clauses)
+      s.add(c);
 
-      std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses" << std::endl;
+    std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses" << std::endl;
 
-      // run the SAT solver
-      if (!s.solve())
-      {
-        std::cout << "c no more solutions" << std::endl;
-        break;
-      }
-
-      solutions++;
+    // run the SAT solver
+    if (!s.solve())
+    {
+      std::cout << "c no more solutions" << std::endl;
+      break;
+    }
 
-      // print solution
-      std::cout << "c solution:" << std::endl;
-      std::cout << "c  ";
-      for (auto x = 0; x < size; x++)
-        std::cout << (hints[x] > '0' ? hints[x] : '-');
-      std::cout << std::endl;
+    solutions++;
 
-      Clause exclude;
-      for (auto y = 0; y < size; y++)
-      {
-        std::cout << "c " << (hints[hints.size() - 1 - y] > '0' ? hints[hints.size() - 1 - y] : '|');
-
-        for (auto x = 0; x < size; x++)
-        {
-          // look for the only true variable
-          auto baseId = (x + y * size) * size;
-          for (auto digit = 1; digit <= size; digit++)
-            if (s.query(baseId + digit))
-            {
-              std::cout << digit;
-              exclude.push_back(-(baseId + digit));
-              break;
-            }
-        }
+    // print solution
+    std::cout << "c solution:" << std::endl;
+    std::cout << "c  ";
+    for (auto x = 0; x < size; x++)
+      std::cout << (hints[x] > '0' ? hints[x] : '-');
+    std::cout << std::endl;
 
-        std::cout << (hints[size + y] > '0' ? hints[size + y] : '|') << std::endl;;
-      }
+    Clause exclude;
+    for (auto y = 0; y < size; y++)
+    {
+      std::cout << "c " << (hints[hints.size() - 1 - y] > '0' ? hints[hints.size() - 1 - y] : '|');
 
-      std::cout << "c  ";
       for (auto x = 0; x < size; x++)
-        std::cout << (hints[3*size - 1 - x] > '0' ? hints[3*size - 1 - x] : '-');
-      std::cout << std::endl;
-
-      // print model
-      std::cout << "v ";
-      for (auto i = 1; i <= numVars; i++)
-        std::cout << " " << (s.query(i) ? +i : -i);
-      std::cout << "0" << std::endl;
-
-      // create CNF file
-      if (solutions == 1)
       {
-        CnfWriter writer(numVars);
-        for (auto& c : clauses)
-          writer.add(c);
-        writer.write("microskyscrapers.cnf");
+        // look for the only true variable
+        auto baseId = (x + y * size) * size;
+        for (auto digit = 1; digit <= size; digit++)
+          if (s.query(baseId + digit))
+          {
+            std::cout << digit;
+            exclude.push_back(-(baseId + digit));
+            break;
+          }
       }
 
-      if (!findAllSolutions)
-        break;
-
-      // keep going, look for other solutions
-      clauses.push_back(exclude);
+      std::cout << (hints[size + y] > '0' ? hints[size + y] : '|') << std::endl;;
     }
-    catch (const char* e)
+
+    std::cout << "c  ";
+    for (auto x = 0; x < size; x++)
+      std::cout << (hints[3*size - 1 - x] > '0' ? hints[3*size - 1 - x] : '-');
+    std::cout << std::endl;
+
+    // print model
+    std::cout << "v ";
+    for (auto i = 1; i <= numVars; i++)
+      std::cout << " " << (s.query(i) ? +i : -i);
+    std::cout << "0" << std::endl;
+
+    // create CNF file
+    if (solutions == 1)
     {
-      // out of memory, restart with larger allocation
-      satMemory *= 2;
-      std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
+      CnfWriter writer(numVars);
+      for (auto& c : clauses)
+        writer.add(c);
+      writer.write("microskyscrapers.cnf");
     }
+
+    if (!findAllSolutions)
+      break;
+
+    // keep going, look for other solutions
+    clauses.push_back(exclude);
   }
 
   // failed
@@ -169,141 +169,132 @@ int main()
       clauses.push_back({ -id(x,y), -id(x,y+1), -id(x,y+2) }); // no 111 in any column
     }
 
-  auto satMemory = 10*1000; // 10,000 temporaries are sufficient for the given problems (even the big ones)
+  auto satMemory = 10*1000; // 10,000 temporaries are sufficient for the given problems (the solver grows its memory if needed)
 
   auto iterations = 0;
   auto solutions  = 0;
   while (true)
   {
-    try
-    {
-      // --------------- SAT solver ---------------
+    // --------------- SAT solver ---------------
 
-      auto numVars = width * height;
-      MicroSAT s(numVars, satMemory);
+    auto numVars = width * height;
+    MicroSAT s(numVars, satMemory);
 
-      // add clauses
-      for (auto& c : clauses)
-        s.add(c);
+    // add clauses
+    for (auto& c : clauses)
+      s.add(c);
 
-      iterations++;
-      std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
+    iterations++;
+    std::cout << "c " << numVars << " variables, " << clauses.size() << " clauses, after " << iterations << " iteration(s):" << std::endl;
 
-      // run the SAT solver
-      if (!s.solve())
-        break;
+    // run the SAT solver
+    if (!s.solve())
+      break;
 
-      // --------------- check solution ---------------
+    // --------------- check solution ---------------
 
-      // the number of 0s and 1s (trues & falses) must be identical
+    // the number of 0s and 1s (trues & falses) must be identical
 
-      // actually we could exclude all invalid permutations
-      // but there are too many possibilities especially
-      // if the board is large (14x14 or more)
-      // so it's actually faster to generate pseudo-legal solutions,
-      // check them and exclude certain invalid configurations we encounter
+    // actually we could exclude all invalid permutations
+    // but there are too many possibilities especially
+    // if the board is large (14x14 or more)
+    // so it's actually faster to generate pseudo-legal solutions,
+    // check them and exclude certain invalid configurations we encounter
 
-      // display candidate
-      std::cout << "c candidate " << iterations << ":" << std::endl;
-      for (auto y = 0; y < height; y++)
-      {
-        std::cout << "c ";
-        for (auto x = 0; x < width; x++)
-          std::cout << (s.query(id(x,y)) ? '1' : '0');
-        std::cout << std::endl;
-      }
+    // display candidate
+    std::cout << "c candidate " << iterations << ":" << std::endl;
+    for (auto y = 0; y < height; y++)
+    {
+      std::cout << "c ";
+      for (auto x = 0; x < width; x++)
+        std::cout << (s.query(id(x,y)) ? '1' : '0');
+      std::cout << std::endl;
+    }
 
-      // count 0s and 1s
-      auto numMismatches = 0;
-      // check rows
-      for (auto y = 0; y < height; y++)
-      {
-        Clause exclude;
-        auto count0 = 0;
-        auto count1 = 0;
-        for (auto x = 0; x < width; x++)
-          if (s.query(id(x,y)))
-          {
-            count1++;
-            exclude.push_back(-id(x,y));
-          }
-          else
-          {
-            count0++;
-            exclude.push_back(+id(x,y));
-          }
-
-        // that's an invalid row
-        if (count0 != count1)
+    // count 0s and 1s
+    auto numMismatches = 0;
+    // check rows
+    for (auto y = 0; y < height; y++)
+    {
+      Clause exclude;
+      auto count0 = 0;
+      auto count1 = 0;
+      for (auto x = 0; x < width; x++)
+        if (s.query(id(x,y)))
         {
-          clauses.push_back(exclude);
-          numMismatches++;
+          count1++;
+          exclude.push_back(-id(x,y));
         }
-      }
-
-      // and the same procedure for columns
-      // (identical code, just x- and y-loops exchanged)
-      for (auto x = 0; x < width; x++)
-      {
-        Clause exclude;
-        auto count0 = 0;
-        auto count1 = 0;
-        for (auto y = 0; y < height; y++)
-          if (s.query(id(x,y)))
-          {
-            count1++;
-            exclude.push_back(-id(x,y));
-          }
-          else
-          {
-            count0++;
-            exclude.push_back(+id(x,y));
-          }
-
-        // that's an invalid row
-        if (count0 != count1)
+        else
         {
-          clauses.push_back(exclude);
-          numMismatches++;
+          count0++;
+          exclude.push_back(+id(x,y));
         }
-      }
 
-      // if number of 0s and 1s match in each row and column then the candidate is a solution
-      if (numMismatches == 0)
+      // that's an invalid row
+      if (count0 != count1)
       {
-        std::cout << "c solution found !" << std::endl;
-        solutions++;
-
-        // final state of all variables
-        std::cout << "v ";
-        for (auto i = 1; i <= numVars; i++)
-          std::cout << (s.query(i) ? +i : -i) << " ";
-        std::cout << "0" << std::endl;
+        clauses.push_back(exclude);
+        numMismatches++;
+      }
+    }
 
-        // create CNF file
-        if (solutions == 1)
+    // and the same procedure for columns
+    // (identical code, just x- and y-loops exchanged)
+    for (auto x = 0; x < width; x++)
+    {
+      Clause exclude;
+      auto count0 = 0;
+      auto count1 = 0;
+      for (auto y = 0; y < height; y++)
+        if (s.query(id(x,y)))
         {
-          CnfWriter writer(numVars);
-          for (auto& c : clauses)
-            writer.add(c);
-          writer.write("microtohuwavohu.cnf");
+          count1++;
+          exclude.push_back(-id(x,y));
+        }
+        else
+        {
+          count0++;
+          exclude.push_back(+id(x,y));
         }
 
-        if (!findAllSolutions)
-          break;
-
-        // exclude this solution and keep searching
-        Clause exclude;
-        for (auto i = 1; i <= numVars; i++)
-          exclude.push_back(s.query(i) ? -i : +i);
+      // that's an invalid row
+      if (count0 != count1)
+      {
         clauses.push_back(exclude);
+        numMismatches++;
       }
     }
-    catch (const char* e)
+
+    // if number of 0s and 1s match in each row and column then the candidate is a solution
+    if (numMismatches == 0)
     {
-      // out of memory, restart with larger allocation
-      satMemory += 10000;
-      std::cout << "c need more memory ... " << e << " now: " << satMemory << std::endl;
+      std::cout << "c solution found !" << std::endl;
+      solutions++;
+
+      // final state of all variables
+      std::cout << "v ";
+      for (auto i = 1; i <= numVars; i++)
+        std::cout << (s.query(i) ? +i : -i) << " ";
+      std::cout << "0" << std::endl;
+
+      // create CNF file
+      if (solutions == 1)
+      {
+        CnfWriter writer(numVars);
+        for (auto& c : clauses)
+          writer.add(c);
+        writer.write("microtohuwavohu.cnf");
+      }
+
+      if (!findAllSolutions)
+        break;
+
+      // exclude this solution and keep searching
+      Clause exclude;
+      for (auto i = 1; i <= numVars; i++)
+        exclude.push_back(s.query(i) ? -i : +i);
+      clauses.push_back(exclude);
     }
   }
 
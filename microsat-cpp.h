@@ -47,7 +47,9 @@
   - zero is a special marker denoting the end of a clause and should not be used for the add() function.
 
   In the example above, two variables x1 and x2 exist:
-  - the constructor needs to know the total number of variables (see "MicroSAT s(2);")
+  - the constructor needs to know the total number of variables (see "MicroSAT s(2);"),
+    more variables can be added later: newVar() returns the number of a new variable (a single-pass encoder
+    may even start with "MicroSAT s;" and call newVar() for each variable)
   - x2 is defined as false (see "s.add(-2);")
   - x1 is initially unknown (there's no "s.add(+1);" or "s.add(-1);")
   - one clause / constraint needs to be fulfilled:
@@ -63,32 +65,184 @@
 
   If solve() returns true then you may want to get a detailled solution, too:
   the function query(x) returns whether variable x is true or false in the solution found
-
-  A const char* exception is thrown if default memory allocation wasn't sufficient: "out of memory"
-  Just increase the constructor's second parameter (default: 1 << 20, which means 1 million temporaries).
+  getModel() returns the whole solution packed into 32 bit integers (variable x is bit x & 31 of element x >> 5)
+  and getModel(bits, size) copies it to a caller-supplied buffer.
+
+  Incremental solving: solve() can be called multiple times, with or without temporary assumptions.
+    auto assumptions = { +1, -3 }; s.solve(assumptions);        // satisfiable if x1 is true and x3 is false ?
+  If solve(assumptions) returns false then failed(lit) tells whether assumption lit was needed for the conflict
+  and getFailed(size) returns all of them (final conflict analysis, a small subset of the assumptions).
+  Assumptions are not permanent, they only affect this single call. New clauses can be added between
+  two calls of solve(), they are permanent. Learned lemmas, saved phases and
+  the decision order are kept between calls. setLemmaRetention(percent) defines how many lemmas survive
+  (default: 50 percent, "glue" lemmas with an LBD of at most 2 are always kept). Calling solve(false)
+  releases all memory which disables further calls.
+
+  enumerate(callback, projection, limit) finds all solutions (or up to limit solutions if limit > 0):
+    auto callback = [](const MicroSAT& solution) { return true; }; // return false to stop early
+    std::vector<int> projection = { 1, 2 };                      // only distinct values of x1 and x2 count
+    auto count = s.enumerate(callback, projection, 2);             // e.g. check whether a solution is unique
+  Each solution is permanently excluded by a clause over the projected variables (all if projection is empty).
+
+  Cardinality constraints are encoded by a sequential counter, its auxiliary variables are appended
+  after all existing variables (getNumVars() returns the new total):
+    std::vector<int> digits = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    s.addExactlyOne(digits);                                       // also addAtMostOne(lits) and addAtMostK(lits, k)
+  The auxiliary variables aren't always determined by the other variables, enumerate() needs a projection then.
+
+  All tuning parameters are defined by a policy (compile-time constants, thus no run-time overhead at all):
+    struct Puzzles : MicroSATPolicy {                              // Derive from the default settings
+      static const RestartStrategy Restarts = LubyRestarts;        // And override a few of them
+      enum { InitialMaxLemmas = 500 }; };
+    BasicMicroSAT<Puzzles> s(2);                                   // MicroSAT is just BasicMicroSAT<MicroSATPolicy>
+
+  Budgets and cancellation: solve() gives up if a limit is reached. Then getStatus() returns UNKNOWN
+  (instead of SATISFIABLE or UNSATISFIABLE) and the solver can be resumed by calling solve() again.
+    s.setBudget(100000, 0);                                        // at most 100000 conflicts, unlimited propagations
+    s.setTerminate(&flag, [](void* f) { return (int) ((std::atomic<bool>*) f)->load(); }); // IPASIR-style callback
+  The callback is polled after each conflict and every 1024 decisions, e.g. to implement a time limit.
+
+  getStats() returns the number of conflicts, decisions, propagations, restarts, calls of reduceDB and lemmas
+  as well as the (peak) memory usage of the clause database, e.g. to choose mem_max. setProgress(state, callback)
+  receives these statistics every Policy::ProgressInterval conflicts. Policy::Statistics = 0 disables all counters.
+
+  Lemma sharing (e.g. between parallel solvers, see parallelmicrosat.h): setLemmaExport's callback receives
+  each new lemma and setLemmaImport's callback returns other solvers' lemmas, one after another, after each restart.
+  Imported lemmas must be implied by the clauses of this solver.
+
+  All memory can be provided by a custom allocator (e.g. huge pages, NUMA-local memory or a pre-allocated pool):
+  MicroSAT s(nVars, mem_max, state, allocate, release) calls allocate(state, bytes) instead of operator new
+  and release(state, memory, bytes) instead of delete[]. If release is zero then the caller owns all memory.
+
+  Proof logging (DRAT) must be enabled by the policy, then each lemma and each deleted lemma is buffered
+  and passed to a callback (at least once per call of solve):
+    struct Proof : MicroSATPolicy { enum { ProofLogging = 1 }; };
+    BasicMicroSAT<Proof> s(nVars); FILE* f = fopen("proof.drat", "wb");
+    s.setProof(f, [](void* f, const unsigned char* data, unsigned int size) { fwrite(data, 1, size, (FILE*) f); });
+  If solve() returns false (without assumptions) then the proof ends with the empty clause. It refers to all clauses
+  passed to add() (including cardinality constraints, but not blocking clauses of enumerate) and is only valid
+  as long as no lemmas are imported. Lemmas which are the reason of a top level unit are never deleted,
+  thus checkers which honor unit deletions (e.g. forward checking) accept the proof, too.
+
+  Policy::PackedVariables = 1 stores the labels of both literals, the reason and the decision list's links of each
+  variable in a single 16 byte record (64 byte aligned) instead of separate arrays. It is disabled by default:
+  on random 3-SAT (300000 variables) the shifted index computation costs more than the saved cache misses.
+
+  Clauses with at least Policy::LongClauses literals are searched for a new watch by Policy::scan(), e.g.
+  simdscan.h's SimdScanPolicy checks eight literals at once (AVX2 gathers if the CPU supports them).
+
+  reset(nVars) discards all clauses but keeps the allocated memory, e.g. to solve many small problems in a row.
+
+  The clause database grows automatically, the constructor's second parameter is just its initial size
+  (default: 1 << 20, which means 1 million temporaries). A const char* exception "out of memory" is only
+  thrown if the database would exceed 2^31 integers (clauses are referenced by signed 32 bit offsets).
 *************************************************************************************/
 
-class MicroSAT {
-protected:
-  int   m_nVars;                                            // The variables are described in the initCDCL procedure
-  int  *m_DB, *m_buffer, *m_reason, *m_falseStack, *m_first, *m_forced, *m_processed, *m_assigned, *m_next, *m_prev;
-  unsigned int m_mem_used, m_mem_max, m_mem_fixed, m_maxLemmas, m_nLemmas, m_fast, m_slow, m_head;
-  char *m_false; bool *m_model;
+struct MicroSATPolicy {                                     // Default settings, derive from it to override some of them
+  enum RestartStrategy { NoRestarts, GlucoseRestarts, LubyRestarts }; // Glucose: restart if the recent LBD average is high
+  static const RestartStrategy Restarts = GlucoseRestarts;  // Luby: 1,1,2,1,1,2,4,... times LubyUnit conflicts
+  enum { RestartMargin = 80, LubyUnit = 512 };              // Glucose: restart if fast average > slow average * 80 / 64
+  enum { InitialMaxLemmas = 2000, LemmaIncrement = 300 };   // Reduce the lemma database if it exceeds this (growing) limit
+  enum { ReduceKeep = 6 };                                  // Keep lemmas with less than 6 literals satisfied by the model
+  enum { GlueLBD = 2, UsedLBD = 6 };                        // Lemmas with a small LBD are kept forever or if recently used
+  enum { LemmaRetention = 50 };                             // Default percentage of lemmas kept between calls of solve()
+  enum { Statistics = 1, ProgressInterval = 10000 };        // Count conflicts etc. (0: no overhead), see setProgress
+  enum { ProofLogging = 0, ProofBuffer = 1 << 16 };         // 1: setProof() writes a DRAT proof (buffered, 64 KB)
+  enum { PackedVariables = 0 };                             // 1: a 16 byte record per variable instead of separate arrays
+  enum { LongClauses = 0 };                                 // Clauses with at least that many literals use scan() (0: never)
+  static inline int scan (const char* falses, const int* lits, int size) { // Index of the first literal which is not false
+    int i = 0; while (i < size && falses[lits[i]]) i++; return i; } // (or size), see simdscan.h for a vectorized version
+};
+
+struct MicroSATStats {                                      // Returned by getStats(), all counters start at zero
+  unsigned long long conflicts, decisions, propagations;    // After construction or reset() (and stay zero if the
+  unsigned long long restarts, reductions, lemmas, imported;// Policy disables statistics): reductions = calls of reduceDB
+  unsigned int nLemmas, memory, peakMemory, maxMemory, pairs; // Lemmas and integers used/allocated by the clause database
+};
 
-  enum { END = -9, UNSAT = 0, SAT = 1, MARK = 2, NOTIMPLIED = 5, IMPLIED = 6 };// Internal constants, DON'T CHANGE
-  enum { InitialMaxLemmas = 2000, LemmaIncrement = 300 };   // Adjust these two lemma constants to tweak performance
+template <typename Policy = MicroSATPolicy>
+class BasicMicroSAT {
+protected:
+  enum { Packed = Policy::PackedVariables != 0, Stride = Packed ? 4 : 1 }; // Record: labels of +x and -x, reason, next, prev
+  struct Labels {                                           // Labels of all literals, non-zero means false
+    char* base; inline char& operator[] (int lit) const {   // Packed: the first two bytes of a variable's record
+      return Packed ? base[16 * (lit >= 0 ? lit : -lit) + (lit < 0)] : base[lit]; } };
+  struct Fields {                                           // One integer per variable
+    int* base; inline int& operator[] (int var) const { return base[Stride * var]; } };
+
+  int   m_nVars, m_capacity;                                // The variables are described in the initCDCL procedure
+  int  *m_DB, *m_vars, *m_buffer, *m_falseStack, *m_forced, *m_processed, *m_assigned;
+  Fields m_reason, m_next, m_prev;                          // Separate arrays or fields of each variable's record
+  unsigned int m_mem_used, m_mem_max, m_mem_fixed, m_vars_used, m_maxLemmas, m_nLemmas, m_nConflicts, m_fast, m_slow, m_head;
+  unsigned int m_nRestarts, m_lubyConflicts;                // Only needed for Luby restarts
+  unsigned int m_nPropagations, m_maxConflicts, m_maxPropagations, m_status; // Budgets per call of solve(), zero means no limit
+  void *m_terminateState; int (*m_terminate) (void* state); // Callback returns non-zero to stop the solver
+  void *m_exportState; void (*m_export) (void* state, const int* lemma, unsigned int size, unsigned int lbd); // Share lemmas
+  void *m_importState; const int* (*m_import) (void* state, unsigned int* size, unsigned int* lbd); // With other solvers
+  void *m_progressState; void (*m_progress) (void* state, const MicroSATStats* stats); // Called periodically
+  void *m_proofState; void (*m_proofWrite) (void* state, const unsigned char* data, unsigned int size); // DRAT output
+  unsigned char* m_proofBuffer; unsigned int m_proofUsed; bool m_proofBinary; // Only if Policy::ProofLogging is non-zero
+  void *m_allocState; void* (*m_allocate) (void* state, unsigned long long bytes); // Custom memory allocation (optional)
+  void (*m_release) (void* state, void* memory, unsigned long long bytes);
+  Labels m_false; unsigned int* m_model; bool m_unsatisfiable; // The model is packed: 32 variables per integer
+  int  *m_assumptions; unsigned int m_maxAssumptions, m_nFailed, m_retention; // The failed assumptions are moved to the front
+  int  *m_literals; unsigned int m_maxLiterals;             // Copy of a container's literals, see addAtMostK
+  MicroSATStats m_stats;                                    // Only if Policy::Statistics is non-zero
+  struct Watches { unsigned int start, size, max; };       // Pairs of a literal and a clause offset, stored in m_pairs
+  Watches *m_watches, *m_implications;                      // One list per literal, scanned when the literal is falsified
+  int  *m_pairs; unsigned int m_pairs_used, m_pairs_max;   // A single arena for all lists
+
+  enum { UNSAT = 0, SAT = 1, MARK = 2, NOTIMPLIED = 5, IMPLIED = 6 };// Internal constants, DON'T CHANGE
+  enum { InitialMaxLemmas = Policy::InitialMaxLemmas, LemmaIncrement = Policy::LemmaIncrement }; // See MicroSATPolicy
+  enum { GlueLBD = Policy::GlueLBD, UsedLBD = Policy::UsedLBD };
+  enum { PERMANENT = 1, USED = 2, FLAGS = 2 };              // Clause header: size, then (LBD << FLAGS) | USED | PERMANENT
+
+  enum { MaxMemory = 0x7FFFFFFF };                          // Clauses are referenced by int offsets
 
   inline int abs (int x) { return x >= 0 ? +x : -x; }       // Return absolute value (avoids #include <cstdlib> )
 
   template <typename T>
-  T* getMemory (unsigned int numElements) {                 // Allocate memory for mem_size integers
+  T* allocate (unsigned long long numElements) {            // Allocate uninitialized memory for numElements elements
+    if (!m_allocate) return new T[numElements];             // Default is operator new
+    T* memory = (T*) m_allocate (m_allocState, numElements * sizeof (T)); // Otherwise use the custom allocator
+    if (!memory) throw "out of memory";
+    return memory; }
+
+  template <typename T>
+  void release (T* memory, unsigned long long numElements) {// Deallocate memory returned by allocate<T>
+    if (!memory) return;
+    if (!m_allocate) delete[] memory;                       // A custom allocator without release function:
+    else if (m_release) m_release (m_allocState, memory, numElements * sizeof (T)); } // Memory is owned by the caller
+
+  inline unsigned int modelSize (int nVars) const { return (unsigned int) (nVars >> 5) + 1; } // Size of m_model
+  inline bool getPhase (int var) const { return (m_model[var >> 5] >> (var & 31)) & 1; } // Bit var of the packed model
+  inline void setPhase (int var, bool value) {              // Set or clear that bit (without branches)
+    unsigned int& bits = m_model[var >> 5]; unsigned int mask = 1U << (var & 31);
+    bits = (bits & ~mask) | (value ? mask : 0); }
+
+  inline unsigned int varsSize (int nVars) const {          // Size of m_vars (packed records need 16 ints for alignment,
+    return Packed ? 6*nVars + 21 : 5*nVars + 5 + (2*nVars + 4) / 4; } // The labels are followed by 4 bytes for 32 bit gathers)
+
+  int* getMemory (unsigned int mem_size) {                  // Allocate memory for mem_size integers
+    if (m_mem_used + mem_size > m_mem_max) {                // Check whether still some space available
+      if (mem_size > MaxMemory - m_mem_used) throw "out of memory"; // Offsets wouldn't fit into an int anymore
+      unsigned int mem_max = m_mem_max < MaxMemory / 2 ? 2 * m_mem_max : (unsigned int) MaxMemory; // Double
+      if (mem_max < m_mem_used + mem_size) mem_max = m_mem_used + mem_size;
+      int* db = allocate<int> (mem_max);                    // Allocate a larger database
+      for (unsigned int i = 0; i < m_mem_used; i++) db[i] = m_DB[i]; // Copy all clauses: they are referenced
+      release (m_DB, m_mem_max); m_DB = db; m_mem_max = mem_max; } // By offset only, hence no need to relocate anything
+    int* store = m_DB + m_mem_used;                         // Compute a pointer to the new memory location
+    m_mem_used += mem_size;                                 // Update the size of the used memory
+    if (Policy::Statistics && m_mem_used > m_stats.peakMemory) m_stats.peakMemory = m_mem_used; // High-water mark
+    return store; }                                         // Return the pointer
+
+  template <typename T>
+  T* getVarMemory (unsigned int numElements) {              // Allocate per-variable memory (never grows)
     const unsigned int PerInt = sizeof (int) / sizeof (T);  // Compact storage for non-ints
     unsigned int mem_size = numElements;
     if (PerInt > 1) mem_size = (numElements + PerInt - 1) / PerInt;
-    if (m_mem_used + mem_size > m_mem_max)                  // Check whether still some space available
-      throw "out of memory";
-    int* store = m_DB + m_mem_used;                         // Compute a pointer to the new memory location
-    m_mem_used += mem_size;                                 // Update the size of the used memory
+    int* store = m_vars + m_vars_used;                      // Compute a pointer to the new memory location
+    m_vars_used += mem_size;                                // Update the size of the used memory
     return (T*) store; }                                    // Return the pointer
 
   void assign (const int* reason, bool forced) {            // Make the first literal of the reason true
@@ -96,42 +250,142 @@ protected:
     m_false[-lit] = forced ? IMPLIED : SAT;                 // Mark lit as true and IMPLIED if forced
     *(m_assigned++) = -lit;                                 // Push it on the assignment stack
     m_reason[abs (lit)] = 1 + (int) (reason - m_DB);        // Set the reason clause of lit
-    m_model [abs (lit)] = (lit > 0); }                      // Mark the literal as true in the model
+    setPhase (abs (lit), lit > 0); }                        // Mark the literal as true in the model
 
   inline void unassign (int lit) { m_false[lit] = UNSAT; }  // Unassign the literal
 
-  inline void addWatch (int lit, unsigned int mem) {        // Add a watch pointer to a clause containing lit
-    m_DB[mem] = m_first[lit]; m_first[lit] = mem; }         // By updating the database and the pointers
-
-  const int* addClause (const int* in, unsigned int size, bool irr) { // Adds a clause stored in *in of size size
+  void movePairs (Watches& list, int* pairs, unsigned int& used) { // Copy a list to a new arena
+    for (unsigned int j = 0; j < 2 * list.size; j++) pairs[used + j] = m_pairs[list.start + j];
+    list.start = used; used += 2 * list.max; }
+
+  void compactPairs (unsigned int extra) {                  // Copy all lists to a new arena without any gaps
+    unsigned long long size = 2 * extra;                    // And reserve space for one more list
+    for (int i = -m_nVars; i <= +m_nVars; i++) size += 2 * (m_watches[i].max + m_implications[i].max);
+    if (size > MaxMemory) throw "out of memory";
+    size = 2 * size < MaxMemory ? 2 * size : (unsigned int) MaxMemory;   // Leave at least as much space for growing lists
+    if (size < m_pairs_max) size = m_pairs_max;             // The arena never shrinks
+    int* pairs = allocate<int> (size); unsigned int used = 0;
+    for (int i = -m_nVars; i <= +m_nVars; i++) {            // A single linear sweep: each literal's watches
+      movePairs (m_watches     [i], pairs, used);           // Are followed by its implications
+      movePairs (m_implications[i], pairs, used); }
+    release (m_pairs, m_pairs_max); m_pairs = pairs;
+    m_pairs_used = used; m_pairs_max = (unsigned int) size; }
+
+  void addPair (Watches& list, int lit, int clause) {       // Append a literal and a clause offset to a list
+    if (list.size == list.max) {                            // Each list is a contiguous array inside the arena:
+      unsigned int max = 2 * list.max + 4;                  // If it's full then move it to the end of the arena
+      if (m_pairs_used + 2 * max > m_pairs_max) compactPairs (max); // Note: the pointer to m_pairs may change
+      for (unsigned int i = 0; i < 2 * list.size; i++)      // Its old memory is released by the next compaction
+        m_pairs[m_pairs_used + i] = m_pairs[list.start + i];
+      list.start = m_pairs_used; list.max = max; m_pairs_used += 2 * max; }
+    int* pairs = m_pairs + list.start + 2 * list.size++;    // The literal can be checked without
+    pairs[0] = lit; pairs[1] = clause; }                    // Touching the clause
+
+  inline void addWatch (int lit, int blocker, int clause) { // Add a watch to a clause containing lit:
+    addPair (m_watches[lit], blocker, clause); }            // If the blocker is true then the clause is satisfied
+
+  inline void addImplication (int lit, int implied, int clause) { // If lit becomes false then implied becomes true:
+    addPair (m_implications[lit], implied, clause); }       // Binary clauses are needed only as a reason
+
+  void deleteWatches () {                                   // Deallocate all watch and implication lists
+    if (!m_watches) return;
+    release (m_watches - m_capacity, 2*m_capacity + 1); release (m_implications - m_capacity, 2*m_capacity + 1);
+    release (m_pairs, m_pairs_max);
+    m_watches = m_implications = 0; m_pairs = 0; m_pairs_max = 0; }
+
+  void flushProof () {                                      // Pass all buffered proof steps to the callback
+    if (m_proofUsed > 0 && m_proofWrite) m_proofWrite (m_proofState, m_proofBuffer, m_proofUsed);
+    m_proofUsed = 0; }
+
+  inline void proofByte (unsigned char c) {                 // Append a byte to the buffered proof
+    if (m_proofUsed == (unsigned int) Policy::ProofBuffer) flushProof ();
+    m_proofBuffer[m_proofUsed++] = c; }
+
+  void proofClause (const int* lits, unsigned int size, bool deleted) { // Log an added or deleted lemma (DRAT)
+    if (!Policy::ProofLogging || !m_proofWrite) return;     // Dead code unless enabled by the policy
+    if (m_proofBinary) {                                    // Binary DRAT: 'a' or 'd', each literal as a
+      proofByte (deleted ? 'd' : 'a');                      // Variable-length integer 2*var + sign, then a zero
+      for (unsigned int i = 0; i < size; i++) {
+        unsigned int x = 2 * abs (lits[i]) + (lits[i] < 0);
+        while (x > 127) { proofByte ((unsigned char) (128 | (x & 127))); x >>= 7; }
+        proofByte ((unsigned char) x); }
+      proofByte (0); return; }
+    if (deleted) { proofByte ('d'); proofByte (' '); }      // Text DRAT: same as a DIMACS clause, "d " for deletions
+    for (unsigned int i = 0; i < size; i++) {
+      unsigned char digits[12]; int n = 0; unsigned int x = abs (lits[i]);
+      if (lits[i] < 0) proofByte ('-');
+      do { digits[n++] = (unsigned char) ('0' + x % 10); x /= 10; } while (x > 0);
+      while (n > 0) proofByte (digits[--n]);
+      proofByte (' '); }
+    proofByte ('0'); proofByte ('\n'); }
+
+  void setUnsatisfiable () {                                // A root level conflict: log the empty clause (once)
+    if (Policy::ProofLogging && !m_unsatisfiable) proofClause (m_buffer, 0, false);
+    m_unsatisfiable = true; }
+
+  const int* addClause (const int* in, unsigned int size, bool irr, unsigned int lbd = 0) { // Adds a clause stored in *in of size size
+    if (Policy::ProofLogging && !irr) proofClause (in, size, false); // Lemmas are part of the proof
     unsigned int i, used = m_mem_used;                      // Store a pointer to the beginning of the clause
-    int* clause = getMemory<int> (size + 3) + 2;            // Allocate memory for the clause in the database
-    if (size > 1) { addWatch (in[0], used  );               // If the clause is not unit, then add
-                    addWatch (in[1], used+1); }             // Two watch pointers to the datastructure
+    int* clause = getMemory (size + 3) + 2;                 // Allocate memory for the clause in the database
+    bool permanent = irr || lbd <= GlueLBD;                 // Irredundant clauses and glue lemmas are never removed
+    clause[-2] = size;                                      // The two integers in front of the clause store its size
+    clause[-1] = (lbd << FLAGS) | (permanent ? PERMANENT : 0); // And its LBD, whether it is permanent or used recently
+    if (size > 2) { addWatch (in[0], in[1], used+2);        // If the clause is longer than binary, then add
+                    addWatch (in[1], in[0], used+2); }      // Two watches to the datastructure
+    if (size == 2) { addImplication (in[0], in[1], used+2); // Binary clauses are stored in both
+                     addImplication (in[1], in[0], used+2); } // Implication lists instead
     for (i = 0; i < size; i++) clause[i] = in[i];           // Copy the clause from the buffer to the database
     clause[i] = 0;
-    if (irr) m_mem_fixed = m_mem_used; else m_nLemmas++;    // Update the statistics
+    if (!permanent) m_nLemmas++;                            // Update the statistics
+    else if (m_mem_fixed == used) m_mem_fixed = m_mem_used; // Permanent clauses are stored below all lemmas if possible
     return clause; }                                        // Return the pointer to the clause in the database
 
   void restart () {                                         // Perform a restart (i.e., unassign all variables)
     while (m_assigned > m_forced) unassign (*(--m_assigned)); // Remove all unforced false lits from falseStack
     m_processed = m_forced; }                               // Reset the processed pointer
 
-  void reduceDB (unsigned int keep = 6) {                   // Removes "less useful" lemmas from DB, keep 6 lemmas
+  void relocateLemmas (Watches& list) {                     // Update all watches of lemmas after compaction
+    int* pairs = m_pairs + list.start; unsigned int kept = 0;
+    for (unsigned int j = 0; j < list.size; j++) {
+      int clause = pairs[2*j + 1];
+      if (clause >= (int) m_mem_fixed) clause = m_DB[clause - 2]; // New offset of a lemma (or zero if removed)
+      if (clause) { pairs[2*kept] = pairs[2*j]; pairs[2*kept + 1] = clause; kept++; } }
+    list.size = kept; }
+
+  bool isProofReason (unsigned int head) {                  // True if the lemma at head is the reason of an assigned
+    if (!Policy::ProofLogging || !m_proofWrite) return false; // Literal (reasons are irrelevant for the search after a
+    int lit = m_DB[head];                                   // Restart, but DRAT checkers reject their deletion)
+    return m_reason[abs (lit)] == (int) head + 1 && m_false[-lit]; }
+
+  void reduceDB (unsigned int keep = Policy::ReduceKeep, bool recent = true) { // Removes "less useful" lemmas from DB
+    if (Policy::Statistics) m_stats.reductions++;
     while (m_nLemmas > m_maxLemmas) m_maxLemmas += LemmaIncrement; // Allow more lemmas in the future
     m_nLemmas = 0;                                          // Reset the number of lemmas
-    for (int i = -m_nVars; i <= +m_nVars; i++) {            // Loop over the variables
-      if (i == 0) continue;                                 // Variable 0 remains unused
-      int* watch = &m_first[i];                             // Get the pointer to the first watched clause
-      while (*watch != END)                                 // As long as there are watched clauses
-        if (*watch < (int) m_mem_fixed) watch = &m_DB[*watch];   // Remove the watch if it points to a lemma
-        else                           *watch =  m_DB[*watch]; } // Otherwise (meaning an input clause) go to next watch
-    int old_used = m_mem_used; m_mem_used = m_mem_fixed;    // Virtually remove all lemmas
-    for (int i = m_mem_fixed + 2; i < old_used; i += 3) {   // While the old memory contains lemmas
-      unsigned int count = 0, head = i;                     // Get the lemma to which the head is pointing
+    unsigned int i, used = m_mem_fixed;                     // Lemmas are stored behind m_mem_fixed
+    for (i = m_mem_fixed + 2; i < m_mem_used; i += 3) {     // While the old memory contains lemmas
+      unsigned int count = 0, head = i, flags = m_DB[i - 1];// Get the lemma to which the head is pointing
       while (m_DB[i]) { int lit = m_DB[i++];                // Count the number of literals
-        if ((lit > 0) == m_model[abs (lit)]) count++; }     // That are satisfied by the current model
-      if (count < keep) addClause (m_DB+head, i-head, false); } } // If the latter is smaller than k, add it back
+        if ((lit > 0) == getPhase (abs (lit))) count++; }   // That are satisfied by the current model
+      bool survive = (flags & PERMANENT) || count < keep || // Keep it if the latter is smaller than k, or if the lemma
+                     (recent && (flags & USED) && (flags >> FLAGS) <= UsedLBD) // Was recently used and has a small LBD,
+                     || isProofReason (head);               // Or if a proof needs it (a reason of a top level unit)
+      if (!(flags & PERMANENT) && survive) m_nLemmas++;
+      if (Policy::ProofLogging && !survive) proofClause (m_DB + head, i - head, true); // Log the deletion
+      m_DB[head - 2] = survive ? used + 2 : 0;              // Temporarily replace the size by the new offset
+      if (survive) used += i - head + 3; }
+    for (int lit = -m_nVars; lit <= +m_nVars; lit++) {      // A single sweep over all lists (they are stored in
+      relocateLemmas (m_watches[lit]);                      // The same order, unless a list grew since the last
+      relocateLemmas (m_implications[lit]); }               // Compaction): remove or update all watches of lemmas
+    for (i = m_mem_fixed + 2; i < m_mem_used; i += 3) {     // Compact the database in place
+      unsigned int head = i, to = m_DB[i - 2], flags = m_DB[i - 1];
+      while (m_DB[i]) i++;                                  // Determine the size of the lemma
+      if (!to) continue;                                    // Skip removed lemmas
+      if (isProofReason (head)) m_reason[abs (m_DB[head])] = (int) to + 1; // Update the reason of a top level unit
+      m_DB[to - 2] = i - head; m_DB[to - 1] = flags & ~USED;// Restore the size and reset the USED flag
+      for (unsigned int j = 0; j <= i - head; j++) m_DB[to + j] = m_DB[head + j]; } // Move it (including the zero)
+    m_mem_used = used;
+    while (m_mem_fixed < m_mem_used && (m_DB[m_mem_fixed + 1] & PERMANENT)) // Permanent clauses at the front
+      m_mem_fixed += m_DB[m_mem_fixed] + 3; }               // Never need to be checked again
 
   void bump (int lit) {                                     // Move the variable to the front of the decision list
     if (m_false[lit] == IMPLIED) return;                    // Nothing to do if implied
@@ -151,7 +405,20 @@ protected:
         m_false[lit] = NOTIMPLIED; return false; }          // Mark and return not implied (denoted by IMPLIED - 1)
     m_false[lit] = IMPLIED; return true; }                  // Mark and return that the literal is implied
 
+  void analyzeFinal (int lit) {                             // Find all assumptions which imply that assumption lit is false
+    m_nFailed = 0; m_assumptions[m_nFailed++] = lit;        // Lit itself is always part of the core, which overwrites the
+    if (m_false[lit] != IMPLIED) m_false[lit] = MARK;       // Decided assumptions (thus it can't exceed their number)
+    for (int* p = m_assigned - 1; p >= m_forced; p--) {     // Walk back along the stack of falsified literals
+      if (m_false[*p] != MARK) continue;                    // Skip literals which don't contribute
+      int reason = m_reason[abs (*p)];
+      if (!reason) { m_assumptions[m_nFailed++] = -*p; continue; } // A decision: only assumptions are decided so far
+      for (const int* q = &m_DB[reason]; *q; q++)           // The other literals of the reason are false, too
+        if (m_false[*q] != IMPLIED) m_false[*q] = MARK; }
+    for (int* p = m_falseStack; p < m_assigned; p++)        // Remove all MARKs (only false literals were marked,
+      if (m_false[*p] == MARK) m_false[*p] = SAT; }         // All of them are on the stack)
+
   const int* analyze (const int* clause) {                  // Compute a resolvent from falsified clause
+    m_nConflicts++; m_DB[clause - m_DB - 1] |= USED;        // Count conflicts and flag the clause as recently used
     while (*clause) bump (*(clause++));                     // MARK all literals in the falsified clause
     while (m_reason[abs (*(--m_assigned))]) {               // Loop on variables on falseStack until the last decision
       if (m_false[*m_assigned] == MARK) {                   // If the tail of the stack is MARK
@@ -159,6 +426,7 @@ protected:
         while (m_false[*(--check)] != MARK)                 // Check for a MARK literal before decision
           if (!m_reason[abs (*check)]) goto build;          // Otherwise it is the first-UIP so break
         clause = &m_DB[m_reason[abs (*m_assigned)]];        // Get the reason and ignore first literal
+        m_DB[clause - m_DB - 2] |= USED;                    // Flag the reason as recently used
         while (*clause) bump (*(clause++)); }               // MARK all literals in reason
       unassign (*m_assigned); }                             // Unassign the tail of the stack
 
@@ -178,122 +446,453 @@ protected:
       unassign (*(m_assigned--));                           // Unassign all lits between tail & head
     unassign (*m_assigned);                                 // Assigned now equal to processed
     m_buffer[size] = 0;                                     // Terminate the buffer (and potentially print clause)
-    return addClause (m_buffer, size, false); }             // Add new conflict clause to redundant DB
+    if (m_export) m_export (m_exportState, m_buffer, size, lbd); // Offer the lemma to other solvers
+    if (Policy::Statistics) { m_stats.conflicts++; m_stats.lemmas++; }
+    return addClause (m_buffer, size, false, lbd); }        // Add new conflict clause to redundant DB
 
   bool propagate () {                                       // Performs unit propagation
     bool forced = m_reason[abs (*m_processed)] != 0;        // Initialize forced flag
     while (m_processed < m_assigned) {                      // While unprocessed false literals
-      int lit = *(m_processed++);                           // Get first unprocessed literal
-      int* watch = &m_first[lit];                           // Obtain the first watch pointer
-      while (*watch != END) {                               // While there are watched clauses (watched by lit)
-        bool unit = true;                                   // Let's assume that the clause is unit
-        int* clause = &m_DB[*watch + 1];                    // Get the clause from DB
-        if (clause[-2] ==   0) clause++;                    // Set the pointer to the first literal in the clause
-        if (clause[ 0] == lit) clause[0] = clause[1];       // Ensure that the other watched literal is in front
-        for (int i = 2; unit && clause[i]; i++)             // Scan the non-watched literals
+      int lit = *(m_processed++); m_nPropagations++;        // Get first unprocessed literal
+      if (Policy::Statistics) m_stats.propagations++;
+      const int* implications = m_pairs + m_implications[lit].start; // Binary clauses first: a sequential scan
+      unsigned int j, size = m_implications[lit].size;      // Of all literals implied by lit
+      for (j = 0; j < size; j++) {
+        int implied = implications[2*j];
+        if (m_false[-implied]) continue;                    // Already satisfied
+        int* clause = &m_DB[implications[2*j + 1]];         // The clause is accessed only if it becomes a reason
+        if (!m_false[implied]) {                            // A unit clause is found:
+          clause[1] = lit; clause[0] = implied;             // Ensure that the implied literal is in front
+          assign (clause, forced); continue; }              // And set the reason
+        if (forced) return false;                           // Found a root level conflict -> UNSAT
+        const int* lemma = analyze (clause);                // Analyze the conflict return a conflict clause
+        if (!lemma[1]) forced = true;                       // In case a unit clause is found, set forced flag
+        assign (lemma, forced); break; }                    // Assign the conflict clause as a unit
+      if (j < size) continue;                               // Continue with the new assignment after a conflict
+      Watches& watches = m_watches[lit];                    // Obtain the watches of lit
+      int* pairs = m_pairs + watches.start;
+      unsigned int kept = 0; size = watches.size;           // Watches which stay in the list are moved to the front
+      for (j = 0; j < size; j++) {                          // While there are watched clauses (watched by lit)
+        int blocker = pairs[2*j], offset = pairs[2*j + 1];
+        if (m_false[-blocker]) {                            // If the blocker is satisfied then skip the clause
+          pairs[2*kept] = blocker; pairs[2*kept++ + 1] = offset; continue; }
+        int* clause = &m_DB[offset];                        // Get the clause from DB
+        if (clause[0] == lit) clause[0] = clause[1];        // Ensure that the other watched literal is in front
+        clause[1] = lit;
+        bool unit = !m_false[-clause[0]];                   // Satisfied if the other watched literal is true
+        int i = 2;                                          // Long clauses: skip all false literals at once
+        if (Policy::LongClauses > 0 && !Packed && unit && clause[-2] >= Policy::LongClauses)
+          i += Policy::scan (m_false.base, clause + 2, clause[-2] - 2);
+        for (; unit && clause[i]; i++)                      // Scan the non-watched literals
           if (!m_false[clause[i]]) {                        // When clause[i] is not false, it is either true or unset
             clause[1] = clause[i]; clause[i] = lit;         // Swap literals
-            int store = *watch; unit = false;               // Store the old watch
-            *watch = m_DB[*watch];                          // Remove the watch from the list of lit
-            addWatch (clause[1], store); }                  // Add the watch to the list of clause[1]
-        if (unit) {                                         // If the clause is indeed unit
-          clause[1] = lit; watch = &m_DB[*watch];           // Place lit at clause[1] and update next watch
-          if ( m_false[-clause[0]]) continue;               // If the other watched literal is satisfied continue
-          if (!m_false[ clause[0]])                         // If the other watched literal is falsified,
-            assign (clause, forced);                        // A unit clause is found, and the reason is set
-          else { if (forced) return false;                  // Found a root level conflict -> UNSAT
-            const int* lemma = analyze (clause);            // Analyze the conflict return a conflict clause
-            if (!lemma[1]) forced = true;                   // In case a unit clause is found, set forced flag
-            assign (lemma, forced); break; } } } }          // Assign the conflict clause as a unit
+            addWatch (clause[1], clause[0], offset);        // Move the watch to the list of clause[1]
+            pairs = m_pairs + watches.start; unit = false; } // The arena may have been compacted
+        if (!unit && clause[1] != lit) continue;            // The watch was moved
+        pairs[2*kept] = clause[0]; pairs[2*kept++ + 1] = offset; // Keep the watch, new blocker
+        if (!unit) continue;                                // If the other watched literal is satisfied continue
+        if (!m_false[ clause[0]])                           // If the other watched literal is falsified,
+          assign (clause, forced);                          // A unit clause is found, and the reason is set
+        else { if (forced) return false;                    // Found a root level conflict -> UNSAT
+          for (unsigned int k = j + 1; k < size; k++) {     // Keep all remaining watches
+            pairs[2*kept] = pairs[2*k]; pairs[2*kept++ + 1] = pairs[2*k + 1]; }
+          watches.size = kept;                              // Analyze may add new watches to this list
+          const int* lemma = analyze (clause);              // Analyze the conflict return a conflict clause
+          if (!lemma[1]) forced = true;                     // In case a unit clause is found, set forced flag
+          assign (lemma, forced); break; } }                // Assign the conflict clause as a unit
+      if (j == size) watches.size = kept; }                 // Remove all moved watches
     if (forced) m_forced = m_processed;                     // Set m_forced if applicable
     return true; }                                          // Finally, no conflict was found
 
+  bool collect (int lit, unsigned int& size, bool& satisfied) { // Append lit to m_buffer (used by add)
+    if (lit == 0 || abs (lit) > m_nVars) return false;      // Reject invalid literals
+    if (m_false[-lit]) satisfied = true;                    // Satisfied by a (permanent) top level unit or lit and -lit
+    else if (!m_false[lit]) {                               // Skip false literals and duplicates:
+      m_false[lit] = MARK; m_buffer[size++] = lit; }        // MARK lit as false until the clause is complete
+    return true; }
+
+  bool addCollected (unsigned int size, bool satisfied, bool valid, bool irr = true, unsigned int lbd = 0) { // Add clause from m_buffer
+    for (unsigned int i = 0; i < size; i++) m_false[m_buffer[i]] = UNSAT; // Remove all MARKs
+    if (!valid)    return false;                            // Clause contained an invalid literal
+    if (satisfied) return true;                             // Satisfied clauses are not needed at all
+    if (size == 0) { setUnsatisfiable (); return false; }   // All literals are false: conflict
+    const int* clause = addClause (m_buffer, size, irr, lbd); // Add that clause to database
+    if (size == 1) assign (clause, true);                   // Directly assign new units (forced)
+    return true; }
+
+  bool addBinary (int a, int b) { int clause[2] = { a, b }; return add (clause, 2); } // Used by the cardinality encodings
+
+  static unsigned int luby (unsigned int x) {               // Compute the x-th element of the Luby sequence
+    unsigned int size = 1, power = 0;                       // 1,1,2,1,1,2,4,1,1,2,1,1,2,4,8,...
+    while (size < x + 1) { power++; size = 2 * size + 1; }  // Find the finite subsequence containing x
+    while (size - 1 != x) { size >>= 1; power--; x %= size; }
+    return 1U << power; }
+
+  bool restartNow () {                                      // Decide after a conflict whether to restart
+    if (Policy::Restarts == MicroSATPolicy::GlucoseRestarts) {
+      unsigned int threshold = (m_slow / 64) * Policy::RestartMargin; // Restart threshold, same as 5/4 but more rounding
+      if (m_fast <= threshold) return false;                // If fast average is substantially larger than slow average
+      m_fast = threshold; return true; }                    // Restart and update the averages
+    if (Policy::Restarts == MicroSATPolicy::LubyRestarts) {
+      if (++m_lubyConflicts < Policy::LubyUnit * luby (m_nRestarts)) return false;
+      m_lubyConflicts = 0; m_nRestarts++; return true; }
+    return m_nLemmas > m_maxLemmas; }                       // NoRestarts: only to reduce the lemma database
+
+  void importLemmas () {                                    // Add lemmas found by other solvers (only after a restart)
+    unsigned int size, lbd; const int* lemma;
+    while (!m_unsatisfiable && (lemma = m_import (m_importState, &size, &lbd)) != 0) {
+      unsigned int i, kept = 0; bool satisfied = false, valid = true;
+      if (Policy::Statistics) m_stats.imported++;
+      for (i = 0; i < size; i++)                            // Same as add(), but it's a lemma
+        valid &= collect (lemma[i], kept, satisfied);
+      addCollected (kept, satisfied, valid, false, lbd); } }
+
+  int search (unsigned int nAssumptions) {                  // Main solve loop, the assumptions are stored in m_assumptions
+    if (m_unsatisfiable) return UNSATISFIABLE;              // A previous call already found a root level conflict
+    int decision = m_head;                                  // Initialize the solver
+    unsigned int assumed = 0, nDecisions = 0;               // Number of assumptions already processed
+    unsigned int conflicts = m_nConflicts, propagations = m_nPropagations; // Budgets start now
+    while (true) {                                          // Main solve loop
+      unsigned int old_nConflicts = m_nConflicts;           // Store nConflicts to see whether propagate adds lemmas
+      if (!propagate ()) {                                  // Propagation returns UNSAT for a root level conflict
+        setUnsatisfiable (); return UNSATISFIABLE; }        // Regardless of any assumptions
+      bool conflict = m_nConflicts != old_nConflicts;
+      if (conflict) {                                       // If the last decision caused a conflict
+        decision = m_head;                                  // Reset the decision heuristic to head
+        assumed  = 0;                                       // Backjumping may have undone some assumptions
+        if (restartNow ()) { restart ();                    // Restart depending on the policy
+          if (Policy::Statistics) m_stats.restarts++;
+          if (m_import) importLemmas ();                    // Get lemmas from other solvers
+          if (m_unsatisfiable) return UNSATISFIABLE;        // Which may even prove unsatisfiability
+          if (m_nLemmas > m_maxLemmas) reduceDB (); } }     // Reduce the DB when it contains too many lemmas
+      if ((m_maxConflicts    && m_nConflicts    - conflicts    >= m_maxConflicts) || // Give up if a budget is exhausted
+          (m_maxPropagations && m_nPropagations - propagations >= m_maxPropagations)) return UNKNOWN;
+      if (m_terminate && (conflict || (++nDecisions & 1023) == 0) && m_terminate (m_terminateState))
+        return UNKNOWN;                                     // Or if the callback asks to stop
+      if (m_progress && m_nConflicts / Policy::ProgressInterval != old_nConflicts / Policy::ProgressInterval) { // Report
+        MicroSATStats stats = getStats (); m_progress (m_progressState, &stats); } // Progress periodically
+
+      int lit = 0;                                          // The next decision literal
+      while (!lit && assumed < nAssumptions) {              // Assumptions are always decided first
+        lit = m_assumptions[assumed++];
+        if (m_false[-lit]) lit = 0; }                       // Skip assumptions which are already true
+      if (lit && m_false[lit]) { analyzeFinal (lit);        // Assumption is false: UNSAT under these assumptions
+        return UNSATISFIABLE; }
+
+      if (!lit) {                                           // No pending assumptions
+        while (m_false[+decision] || m_false[-decision])    // As long as the temporary decision is assigned
+          decision = m_prev[decision];                      // Replace it with the next variable in the decision list
+        if (decision == 0) return SATISFIABLE;              // If the end of the list is reached, then a solution is found
+        lit = getPhase (decision) ? +decision : -decision; }// Otherwise, assign the decision variable based on the model
+      m_false[-lit] = SAT;                                  // Assign the decision literal to true (change to IMPLIED-1?)
+      if (Policy::Statistics) m_stats.decisions++;
+      *(m_assigned++) = -lit;                               // And push it on the assigned stack
+      m_reason[abs (lit)] = 0;                              // Decisions have no reason clauses
+      setPhase (abs (lit), lit > 0); } }                    // Assumptions may differ from the saved phase
+
+  void reduceLemmas () {                                    // Keep only m_retention percent of all lemmas
+    if (m_retention >= 100) return;                         // Nothing to do if all lemmas are kept
+    unsigned int histogram[32] = { 0 }, total = 0, keep = 0;// Number of lemmas per number of satisfied literals
+    for (unsigned int i = m_mem_fixed + 2; i < m_mem_used; i += 3) { // Same loop as in reduceDB
+      unsigned int count = 0; bool permanent = m_DB[i - 1] & PERMANENT;
+      while (m_DB[i]) { int lit = m_DB[i++];                // Count the number of literals
+        if ((lit > 0) == getPhase (abs (lit))) count++; }   // That are satisfied by the current model
+      if (!permanent) { histogram[count < 31 ? count : 31]++; total++; } } // Permanent clauses are always kept
+    unsigned int limit = (unsigned int) ((total * (unsigned long long) m_retention) / 100), kept = 0;
+    while (keep < 32 && kept + histogram[keep] <= limit)    // Find the largest threshold such that
+      kept += histogram[keep++];                            // At most limit lemmas survive
+    reduceDB (keep < 32 ? keep : m_nVars + 1, false); }     // Note: no lemma has more than m_nVars literals
+
   void init (unsigned int nVars, unsigned int mem_max) {    // Same parameters as constructor
-    m_nVars = nVars; if (m_nVars == 0) m_nVars = 1;         // The code assumes that there is at least one variable
-    m_model = new bool[m_nVars + 1];                        // Allocate memory for the final variable assignment
-    m_mem_max = mem_max >= 10*nVars ? mem_max : 10*nVars;   // Need at least about 10 temporary integers per variable
-    m_DB = new int[m_mem_max];                              // Allocate the initial database
+    m_model = 0; m_DB = 0; m_vars = 0; m_nVars = m_capacity = 0; // Nothing allocated yet
+    m_watches = m_implications = 0; m_pairs = 0; m_pairs_max = 0;
+    m_mem_max = mem_max > 0 ? mem_max : 1;                  // Initial size of the database, it grows when needed
+    m_assumptions   = 0;                                    // No assumptions yet, buffer will be allocated on demand
+    m_nFailed       = 0;                                    // No failed assumptions
+    m_maxAssumptions= 0;                                    // Size of the assumptions buffer
+    m_literals = 0; m_maxLiterals = 0;                      // Allocated on demand, too
+    m_retention     = Policy::LemmaRetention;               // Keep half of all lemmas between calls of solve()
+    m_maxConflicts = m_maxPropagations = 0;                 // No budgets
+    m_terminateState = 0; m_terminate = 0;                  // No callbacks
+    m_exportState = m_importState = 0; m_export = 0; m_import = 0;
+    m_progressState = 0; m_progress = 0;
+    m_proofState = 0; m_proofWrite = 0; m_proofBuffer = 0; m_proofUsed = 0; m_proofBinary = true; // No proof
+    prepare (nVars); }
+
+  void reserveVars (int capacity) {                         // Enlarge all per-variable arrays (and keep their contents)
+    unsigned int* model = m_model; int* vars = m_vars; int oldCapacity = m_capacity; // Old memory, released at the end
+    Watches *watches = m_watches, *implications = m_implications;
+    Fields next = m_next, prev = m_prev, reason = m_reason; Labels falses = m_false; int* falseStack = m_falseStack;
+    m_capacity     = capacity;
+    m_model        = allocate<unsigned int> (modelSize (m_capacity)); // Allocate memory for the final variable assignment
+    m_vars         = allocate<int> (varsSize (m_capacity)); // Allocate all per-variable arrays at once
+    m_watches      = allocate<Watches> (2*m_capacity + 1) + m_capacity; // Watch lists
+    m_implications = allocate<Watches> (2*m_capacity + 1) + m_capacity; // Implication lists
+    m_vars_used    = 0;                                     // The number of integers allocated for variables
+    for (unsigned int i = 0; i < varsSize (m_capacity); i++) m_vars[i] = 0; // Unused entries must be zero
+    for (unsigned int i = 0; i < modelSize (m_capacity); i++) m_model[i] = 0; // All variables are false
+    m_buffer     = getVarMemory<int>  (m_capacity  );       // A buffer to store a temporary clause
+    m_falseStack = getVarMemory<int>  (m_capacity+1);       // Stack of falsified literals -- only changed by reserveVars
+    if (Packed) {                                           // All fields touched by assign and bump share a cache line
+      int* records = getVarMemory<int> (4*(m_capacity+1) + 16); // 16 bytes per variable, aligned to 64 bytes
+      records += (16 - (unsigned int) (((unsigned long long) records / sizeof (int)) & 15)) & 15;
+      m_false.base = (char*) records; m_reason.base = records + 1; m_next.base = records + 2; m_prev.base = records + 3;
+    } else {
+      m_next.base   = getVarMemory<int>  (m_capacity+1);    // Next     variable in the heuristic order
+      m_prev.base   = getVarMemory<int>  (m_capacity+1);    // Previous variable in the heuristic order
+      m_reason.base = getVarMemory<int>  (m_capacity+1);    // Array of clauses
+      m_false.base  = getVarMemory<char> (2*m_capacity+1) + m_capacity; } // Labels for variables, non-zero means false
+    if (vars) {                                             // Copy everything if the solver was already in use
+      for (int i = 0; i <= m_nVars; i++) { m_next[i] = next[i]; m_prev[i] = prev[i]; m_reason[i] = reason[i]; m_falseStack[i] = falseStack[i]; }
+      for (unsigned int i = 0; i < modelSize (m_nVars); i++) m_model[i] = model[i];
+      for (int i = -m_nVars; i <= +m_nVars; i++) { m_false[i] = falses[i]; m_watches[i] = watches[i]; m_implications[i] = implications[i]; }
+      m_forced    = m_falseStack + (m_forced    - falseStack); // Rebase the pointers into the stack
+      m_processed = m_falseStack + (m_processed - falseStack);
+      m_assigned  = m_falseStack + (m_assigned  - falseStack); }
+    if (watches) { release (watches - oldCapacity, 2*oldCapacity + 1); release (implications - oldCapacity, 2*oldCapacity + 1); }
+    release (model, modelSize (oldCapacity)); release (vars, varsSize (oldCapacity)); }
+
+  void growVars (int nVars) {                               // Add the variables m_nVars+1 ... nVars (between two solves)
+    if (nVars <= m_nVars || !m_vars) return;                // Not allowed after clauses where deleted
+    if (nVars > m_capacity) reserveVars (nVars > 2*m_capacity ? nVars : 2*m_capacity); // Amortized growth
+    for (int var = m_nVars + 1; var <= nVars; var++) {      // Initialize the new variables
+      Watches empty = { 0, 0, 0 };
+      m_watches[var] = m_watches[-var] = m_implications[var] = m_implications[-var] = empty;
+      m_false[var] = m_false[-var] = UNSAT; setPhase (var, false); m_reason[var] = 0;
+      m_prev[var] = 0; m_next[var] = m_next[0];             // Insert at the tail of the decision list
+      m_prev[m_next[0]] = var; m_next[0] = var;             // (the head stays the same)
+      if (m_head == 0) m_head = var; }                      // Unless the list was empty
+    m_nVars = nVars; }
+
+  void prepare (unsigned int nVars) {                       // Allocate or re-use memory and clear all datastructures
+    int vars = nVars > 0 ? (int) nVars : 1;                 // Allocate memory for at least one variable
+    if (vars > m_capacity || !m_vars) reserveVars (vars);   // Per-variable memory is too small (or was released)
+    m_nVars = (int) nVars;                                  // Zero is fine, too: see newVar()
+    if (!m_DB) m_DB = allocate<int> (m_mem_max);            // Allocate the initial database (keeps its size if grown)
+    for (unsigned int i = 0; i < varsSize (m_capacity); i++) m_vars[i] = 0; // Clear all per-variable arrays
+    for (unsigned int i = 0; i < modelSize (m_capacity); i++) m_model[i] = 0; // And the model (phase-saving)
+    for (int i = -m_capacity; i <= +m_capacity; i++) {      // Empty watch and implication lists
+      Watches empty = { 0, 0, 0 }; m_watches[i] = m_implications[i] = empty; }
 
     m_mem_used      = 0;                                    // The number of integers allocated in the DB
     m_nLemmas       = 0;                                    // The number of learned clauses -- redundant means learned
+    m_nConflicts    = 0;                                    // The number of conflicts
     m_maxLemmas     = InitialMaxLemmas;                     // Initial maximum number of learned clauses (default: 2000)
     m_fast = m_slow = 1 << 24;                              // Initialize the fast and slow moving averages
+    m_unsatisfiable = false;                                // No root level conflict found yet
+    m_nRestarts = m_lubyConflicts = 0;                      // Luby restarts start with the first element
+    m_nPropagations = 0;                                    // No propagations yet
+    m_status = UNKNOWN;                                     // Not solved yet
+    m_pairs_used = 0;                                       // The arena is allocated when needed (or re-used)
+    MicroSATStats none = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; m_stats = none; // No statistics yet
 
-    m_buffer     = getMemory<int>  (m_nVars  );             // A buffer to store a temporary clause
-    m_next       = getMemory<int>  (m_nVars+1);             // Next     variable in the heuristic order
-    m_prev       = getMemory<int>  (m_nVars+1);             // Previous variable in the heuristic order
-    m_reason     = getMemory<int>  (m_nVars+1);             // Array of clauses
-    m_falseStack = getMemory<int>  (m_nVars+1);             // Stack of falsified literals -- this pointer is never changed
     m_forced     = m_falseStack;                            // Points inside *falseStack at first decision (unforced literal)
     m_processed  = m_falseStack;                            // Points inside *falseStack at first unprocessed literal
     m_assigned   = m_falseStack;                            // Points inside *falseStack at last  unprocessed literal
-    m_false      = getMemory<char> (2*m_nVars+1) + m_nVars; // Labels for variables, non-zero means false
-    m_first      = getMemory<int>  (2*m_nVars+1) + m_nVars; // Offset of the first watched clause
     m_DB[m_mem_used++] = 0;                                 // Make sure there is a 0 before the clauses are loaded
+    m_mem_fixed = m_mem_used;                               // No clauses yet
 
     for (int i = 1; i <= m_nVars; i++) {                    // Initialize the main datastructures:
-      m_prev [i] = i - 1; m_next[i-1] = i;                  // Double-linked list for variable-move-to-front,
-      m_model[i] = false;                                   // Model (phase-saving)
-      m_false[i] = m_false[-i] = UNSAT;                     // The false array,
-      m_first[i] = m_first[-i] = END; }                     // And first (watch pointers)
+      m_prev [i] = i - 1; m_next[i-1] = i;                  // Double-linked list for variable-move-to-front
+      m_false[i] = m_false[-i] = UNSAT; }                   // And the false array
     m_false[0] = 0;                                         // Stop-marker
     m_head = m_nVars; }                                     // Initialize the head of the double-linked list
 
 /*************************** public interface **************************************/
 public:
-  MicroSAT (unsigned int nVars, unsigned int mem_max = 1 << 20) { // 2^20 ints => about a million temporaries
+  enum Status { UNKNOWN = 0, SATISFIABLE = 10, UNSATISFIABLE = 20 }; // Result of the last call of solve() (same as IPASIR)
+
+  BasicMicroSAT (unsigned int nVars = 0, unsigned int mem_max = 1 << 20) { // 2^20 ints => about a million temporaries
+    m_allocState = 0; m_allocate = 0; m_release = 0;        // Use operator new and delete[]
     init (nVars, mem_max); }                                // Prepare data structures
 
-  virtual ~MicroSAT () { delete[] m_model; delete[] m_DB; } // Deallocate memory
+  BasicMicroSAT (unsigned int nVars, unsigned int mem_max,  // Same as above, but all memory is provided by allocate
+                 void* state, void* (*allocate) (void* state, unsigned long long bytes), // (must be aligned for ints)
+                 void (*release) (void* state, void* memory, unsigned long long bytes)) { // Release may be zero
+    m_allocState = state; m_allocate = allocate; m_release = release;
+    init (nVars, mem_max); }
+
+  virtual ~BasicMicroSAT () { flushProof (); release (m_proofBuffer, Policy::ProofBuffer); // Finish the proof
+                              release (m_model, modelSize (m_capacity)); release (m_DB, m_mem_max); // Deallocate memory
+                              release (m_vars, varsSize (m_capacity)); release (m_assumptions, m_maxAssumptions);
+                              release (m_literals, m_maxLiterals); deleteWatches (); }
 
   bool add (int var) { return add (&var, 1); }              // Set a unit: true if var is positive or false if negative
 
   bool add (const int* in, unsigned int size) {             // Define a clause
     if (m_DB == 0 || in == 0 || size == 0) return false;    // Not allowed after clauses where deleted
-    const int* clause = addClause (in, size, true);         // Add that clause to database
-    if (size == 1 &&  m_false[ clause[0]]) return false;    // Check for conflicting unit
-    if (size == 1 && !m_false[-clause[0]])                  // Check for a new unit
-      assign (clause, true);                                // Directly assign new units (forced)
-    return true; }
+    unsigned int i, kept = 0; bool satisfied = false, valid = true;
+    for (i = 0; i < size; i++)                              // Copy to internal buffer
+      valid &= collect (in[i], kept, satisfied);
+    return addCollected (kept, satisfied, valid); }         // And add it to the database
 
   template <typename Container>                             // Same as above, but a convenience function for STL containers
   bool add (const Container& v) {                           // A container has to have begin() and end()
-    unsigned int size = 0;                                  // Such as std::vector, std::deque, std::set, std::list
+    unsigned int size = 0; bool satisfied = false, valid = true; // Such as std::vector, std::deque, std::set, std::list
     if (m_DB == 0) return false;                            // Not allowed after clauses where deleted
     typename Container::const_iterator i = v.begin();
     while (i != v.end() && *i != 0)                         // Plain copy to internal buffer, avoid zeros
-      m_buffer[size++] = (int) *i++;
-    return add (m_buffer, size); }                          // And call the other add() function
+      valid &= collect ((int) *i++, size, satisfied);
+    return addCollected (size, satisfied, valid); }         // And add it to the database
+
+  bool addAtMostK (const int* in, unsigned int size, unsigned int k) { // At most k literals are true (sequential counter)
+    if (m_DB == 0 || (in == 0 && size > 0)) return false;   // Not allowed after clauses where deleted
+    for (unsigned int i = 0; i < size; i++)                 // Reject invalid literals before anything is added
+      if (in[i] == 0 || abs (in[i]) > m_nVars) return false;
+    if (k >= size) return true;                             // Always satisfied
+    bool ok = true;
+    if (k == 0) {                                           // All literals are false
+      for (unsigned int i = 0; i < size; i++) ok &= add (-in[i]);
+      return ok; }
+    if (k == 1 && size <= 5) {                              // Pairwise is smaller for a few literals (no extra variables)
+      for (unsigned int i = 0; i < size; i++)
+        for (unsigned int j = i + 1; j < size; j++) ok &= addBinary (-in[i], -in[j]);
+      return ok; }
+    int base = m_nVars; growVars (m_nVars + (int) ((size - 1) * k)); // Sinz 2005: s(i,j) means "at least j of in[0..i] are true"
+    for (unsigned int i = 0; i + 1 < size; i++) {           // (size-1)*k auxiliary variables, O(size*k) clauses
+      int x = in[i], s = base + (int) (i * k), prev = s - (int) k;
+      ok &= addBinary (-x, s + 1);                          // x(i) => s(i,1)
+      if (i == 0) { for (unsigned int j = 2; j <= k; j++) ok &= add (-(s + (int) j)); continue; }
+      ok &= addBinary (-(prev + 1), s + 1);                 // s(i-1,1) => s(i,1)
+      for (unsigned int j = 2; j <= k; j++) {
+        int clause[3] = { -x, -(prev + (int) j - 1), s + (int) j }; // x(i) and s(i-1,j-1) => s(i,j)
+        ok &= add (clause, 3);
+        ok &= addBinary (-(prev + (int) j), s + (int) j); } // s(i-1,j) => s(i,j)
+      ok &= addBinary (-x, -(prev + (int) k)); }            // x(i) and s(i-1,k) is a conflict
+    ok &= addBinary (-in[size - 1], -(base + (int) ((size - 2) * k + k))); // The last literal needs no counter
+    return ok; }
+
+  bool addAtMostOne   (const int* in, unsigned int size) { return addAtMostK (in, size, 1); }
+  bool addExactlyOne  (const int* in, unsigned int size) {  // At least one (a clause) and at most one
+    return add (in, size) && addAtMostK (in, size, 1); }
+
+  template <typename Container>                             // Same as above, but convenience functions for STL containers
+  bool addAtMostK (const Container& v, unsigned int k) {
+    unsigned int size = 0;
+    if (m_DB == 0) return false;                            // Not allowed after clauses where deleted
+    typename Container::const_iterator i;
+    for (i = v.begin(); i != v.end(); i++) size++;          // Count literals
+    if (size > m_maxLiterals) {                             // A separate buffer: add() needs m_buffer and
+      release (m_literals, m_maxLiterals); m_literals = allocate<int> (size); m_maxLiterals = size; } // getFailed() the assumptions
+    size = 0;
+    for (i = v.begin(); i != v.end(); i++) m_literals[size++] = (int) *i;
+    return addAtMostK (m_literals, size, k); }
+  template <typename Container>
+  bool addAtMostOne   (const Container& v) { return addAtMostK (v, 1); }
+  template <typename Container>
+  bool addExactlyOne  (const Container& v) { return add (v) && addAtMostK (v, 1); }
+
+  int newVar () {                                           // Add a variable (amortized growth) and return its number
+    if (!m_vars) return 0;                                  // Not allowed after clauses where deleted
+    growVars (m_nVars + 1); return m_nVars; }
+
+  int getNumVars () const { return m_nVars; }               // Including newVar() and auxiliary variables of addAtMostK
 
   //template <typename T>                                   // Uncomment if your compiler supports std::initializer_list
   //bool add (const std::initializer_list<T>& il) { return add(il); }
 
   bool solve (bool keepClauses = true) {                    // Determine satisfiability
-    if (!m_DB) return m_model[0];                           // Already solved, return previous result
-    int decision = m_head;                                  // Initialize the solver
-    bool result = false;                                    // SAT if true, UNSAT if false
-    while (true) {                                          // Main solve loop
-      unsigned int old_nLemmas = m_nLemmas;                 // Store nLemmas to see whether propagate adds lemmas
-      if (!propagate ()) break;                             // Propagation returns UNSAT for a root level conflict
-      if (m_nLemmas > old_nLemmas) {                        // If the last decision caused a conflict
-        decision = m_head;                                  // Reset the decision heuristic to head
-        unsigned int threshold = (m_slow / 64) * 80;        // Restart threshold, same as 5/4 but more rounding
-        if (m_fast > threshold) {                           // If fast average is substantially larger than slow average
-          m_fast = threshold; restart ();                   // Restart and update the averages
-          if (m_nLemmas > m_maxLemmas) reduceDB (); } }     // Reduce the DB when it contains too many lemmas
+    if (!m_DB) return m_status == SATISFIABLE;              // Already solved, return previous result
+    m_nFailed = 0; m_status = search (0);                   // Run the solver without any assumptions
+    if (keepClauses || m_status == UNKNOWN) {               // Keep the most useful lemmas for the next call
+      restart (); reduceLemmas (); }                        // (always if it gave up: then it can be resumed)
+    else             { release (m_DB, m_mem_max); m_DB = 0; // Deallocate temporary memory
+                       release (m_vars, varsSize (m_capacity)); m_vars = 0; deleteWatches (); }
+    if (Policy::ProofLogging) flushProof ();                // The proof is complete for now
+    return m_status == SATISFIABLE; }                       // And return result
+
+  bool solve (const int* in, unsigned int size) {           // Determine satisfiability under temporary assumptions
+    if (m_DB == 0 || (in == 0 && size > 0)) return false;   // Not allowed after clauses where deleted
+    if (size > m_maxAssumptions) {                          // Need a larger buffer for the assumptions ?
+      release (m_assumptions, m_maxAssumptions); m_assumptions = allocate<int> (size); m_maxAssumptions = size; }
+    unsigned int i, nAssumptions = 0;
+    for (i = 0; i < size; i++)                              // Copy all valid literals to internal buffer
+      if (in[i] != 0 && abs (in[i]) <= m_nVars) m_assumptions[nAssumptions++] = in[i];
+    m_nFailed = 0; m_status = search (nAssumptions);        // Run the solver, assumptions are the first decisions
+    restart (); reduceLemmas ();                            // Keep the most useful lemmas for the next call
+    if (Policy::ProofLogging) flushProof ();                // The proof is complete for now
+    return m_status == SATISFIABLE; }                       // And return result
 
-      while (m_false[+decision] || m_false[-decision])      // As long as the temporary decision is assigned
-        decision = m_prev[decision];                        // Replace it with the next variable in the decision list
-
-      if (decision == 0) { result = true; break; }          // If the end of the list is reached, then a solution is found
-      decision = m_model[decision] ? +decision : -decision; // Otherwise, assign the decision variable based on the model
-      m_false[-decision] = SAT;                             // Assign the decision literal to true (change to IMPLIED-1?)
-      *(m_assigned++) = -decision;                          // And push it on the assigned stack
-      decision = abs (decision); m_reason[decision] = 0; }  // Decisions have no reason clauses
-      if (keepClauses) { restart (); reduceDB (0); }        // Remove all lemmas
-      else             { delete[] m_DB; m_DB = 0; }         // Deallocate temporary memory
-      m_model[0] = result; return result; }                 // And return result
+  template <typename Container>                             // Same as above, but a convenience function for STL containers
+  bool solve (const Container& assumptions) {               // A container has to have begin() and end()
+    unsigned int size = 0;
+    if (m_DB == 0) return false;                            // Not allowed after clauses where deleted
+    typename Container::const_iterator i;
+    for (i = assumptions.begin(); i != assumptions.end(); i++) size++; // Count assumptions
+    if (size > m_maxAssumptions) {                          // Need a larger buffer for the assumptions ?
+      release (m_assumptions, m_maxAssumptions); m_assumptions = allocate<int> (size); m_maxAssumptions = size; }
+    size = 0;
+    for (i = assumptions.begin(); i != assumptions.end(); i++) // Plain copy to internal buffer
+      m_assumptions[size++] = (int) *i;
+    return solve (m_assumptions, size); }                   // And call the other solve() function
+
+  template <typename Callback, typename Container>          // Find all solutions, distinguished by the projected variables
+  unsigned int enumerate (Callback callback, const Container& projection, unsigned int limit = 0) {
+    unsigned int found = 0;                                 // An empty projection means all variables, no limit if zero
+    while ((limit == 0 || found < limit) && solve ()) {     // Stop after limit solutions or if no more solutions exist
+      found++;
+      if (!callback (*this)) break;                         // Callback gets the solver (for query) and returns false to stop
+      unsigned int size = 0; bool satisfied = false, valid = true; // Block the current solution:
+      typename Container::const_iterator i;                 // Negate the model of all projected variables
+      for (i = projection.begin(); i != projection.end(); i++) {
+        int var = (int) *i; if (var <= 0 || var > m_nVars) continue; // Skip invalid variables
+        valid &= collect (getPhase (var) ? -var : +var, size, satisfied); }
+      if (projection.begin() == projection.end())           // An empty projection blocks the full model
+        for (int var = 1; var <= m_nVars; var++)
+          valid &= collect (getPhase (var) ? -var : +var, size, satisfied);
+      if (!addCollected (size, satisfied, valid)) break; }  // All projected variables are fixed: no more solutions
+    return found; }                                         // Return number of solutions (note: blocking clauses are permanent)
+
+  void setLemmaRetention (unsigned int percent) {           // Percentage of lemmas kept after solve() (default: 50)
+    m_retention = percent < 100 ? percent : 100; }          // The remaining lemmas are re-used by the next call
+
+  void setBudget (unsigned int conflicts, unsigned int propagations) { // Limits for each call of solve(), zero = no limit
+    m_maxConflicts = conflicts; m_maxPropagations = propagations; }
+
+  void setTerminate (void* state, int (*terminate) (void* state)) { // Callback returns non-zero to stop solve()
+    m_terminateState = state; m_terminate = terminate; }    // Set terminate to zero to remove the callback
+
+  void setLemmaExport (void* state, void (*callback) (void* state, const int* lemma, unsigned int size, unsigned int lbd)) {
+    m_exportState = state; m_export = callback; }           // Callback receives each new lemma (e.g. to share it)
+
+  void setLemmaImport (void* state, const int* (*callback) (void* state, unsigned int* size, unsigned int* lbd)) {
+    m_importState = state; m_import = callback; }           // Callback is polled after each restart until it returns 0
+
+  void reset (unsigned int nVars) {                         // Start over with a new problem (all clauses are removed)
+    prepare (nVars); }                                      // Re-uses memory, keeps budgets, callbacks and retention
+
+  Status getStatus () const { return (Status) m_status; }   // UNKNOWN if solve() gave up, see setBudget and setTerminate
+
+  MicroSATStats getStats () const {                         // Counters (see MicroSATStats) and current memory usage
+    MicroSATStats stats = m_stats;
+    stats.nLemmas = m_nLemmas; stats.memory = m_mem_used; stats.maxMemory = m_DB ? m_mem_max : 0; stats.pairs = m_pairs_max;
+    return stats; }
+
+  void setProof (void* state, void (*write) (void* state, const unsigned char* data, unsigned int size), bool binary = true) {
+    if (!Policy::ProofLogging) throw "proof logging is disabled by the policy"; // Binary or text DRAT, zero removes it
+    flushProof (); m_proofState = state; m_proofWrite = write; m_proofBinary = binary;
+    if (!m_proofBuffer) m_proofBuffer = allocate<unsigned char> (Policy::ProofBuffer); }
+
+  void setProgress (void* state, void (*callback) (void* state, const MicroSATStats* stats)) { // Called by solve() every
+    m_progressState = state; m_progress = callback; }       // Policy::ProgressInterval conflicts, zero removes it
 
   bool query (unsigned int var) const {                     // Return solution of a single variable
-    return (int) var > m_nVars ? false : m_model[var]; }    // Return false for invalid variables
+    return (int) var > m_nVars ? false : getPhase ((int) var); } // Return false for invalid variables
+
+  bool failed (int lit) const {                             // True if assumption lit is part of the core, i.e.
+    for (unsigned int i = 0; i < m_nFailed; i++)            // solve() found a conflict under these failed assumptions
+      if (m_assumptions[i] == lit) return true;
+    return false; }
+
+  const int* getFailed (unsigned int& size) const {         // All failed assumptions of the last call of solve()
+    size = m_nFailed; return m_assumptions; }               // (empty if the problem is unsatisfiable without them)
+
+  const unsigned int* getModel () const { return m_model; } // Read-only view of the packed solution: variable x is
+                                                            // Bit (x & 31) of getModel()[x >> 5] (bit 0 is always zero)
+  unsigned int getModel (unsigned int* bits, unsigned int size) const { // Copy the packed solution (at most size integers)
+    unsigned int words = modelSize (m_nVars);                // And return how many integers are needed for all variables
+    for (unsigned int i = 0; i < words && i < size; i++) bits[i] = m_model[i];
+    return words; }
 };
+
+typedef BasicMicroSAT<> MicroSAT;                           // Default settings
@@ -0,0 +1,571 @@
+#pragma once
+
+/*********************************************************[parallelmicrosat.h]***
+
+  The MIT License
+
+  Copyright (c) 2020 Stephan Brumme
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*************************************************************************************
+
+  This a portfolio front end for microsat-cpp: several diversified solvers run in parallel on the same problem.
+  The first solver to find an answer wins and stops all others.
+  It has the same API as microsat-cpp (except for enumerate and setLemmaRetention).
+
+  code example:
+    ParallelMicroSAT s(2);                                         // set number of variables (one solver per core)
+    s.add(-2);                                                     // add a unit
+    auto clause = { -1, +2 }; s.add(clause);                       // add a clause
+    if (s.solve()) std::cout <<   "SATISFIABLE" << std::endl;      // run all solvers and print result
+    else           std::cout << "UNSATISFIABLE" << std::endl;
+    std::cout << "variable 1 is " << std::boolalpha << s.query(1); // query variable (true or false)
+
+  The solvers differ in their initial decision order, their initial phases and their restart strategy.
+  The first solver is identical to a plain MicroSAT object.
+  Short lemmas with a low LBD are shared: each solver publishes them in a lock-free ring buffer
+  and picks up the other solvers' lemmas whenever it restarts.
+  Solvers which lost the race keep their state, the next call of solve() resumes their search.
+
+  BatchMicroSAT solves many small independent problems (e.g. a list of Sudokus) on multiple threads:
+    std::vector<std::vector<std::vector<int>>> problems = ...;   // each problem is a list of clauses
+    BatchMicroSAT batch;                                           // one solver per core
+    auto results = batch.solve(problems.begin(), problems.end(),  // the callback is invoked by the worker threads
+                               [](size_t index, const MicroSAT& solver) { ... solver.query(1) ... });
+
+  Each thread keeps its solver (and its memory) across problems and calls of solve().
+  Problems are evenly distributed at first, idle threads steal half of the problems of a busy thread.
+
+  Note: each solver has its own copy of all clauses (and its own lemmas),
+        therefore memory consumption grows linearly with the number of threads.
+        Never call add() with a clause that isn't given to all solvers (which is impossible via this API),
+        otherwise shared lemmas could be invalid.
+        Compile with -pthread.
+*/
+
+#include "microsat-cpp.h"
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// microsat-cpp with a shuffled initial decision order and random initial phases
+template <typename Policy>
+class DiversifiedMicroSAT : public BasicMicroSAT<Policy>
+{
+public:
+  // seed = 0 => same as BasicMicroSAT
+  DiversifiedMicroSAT(unsigned int nVars, unsigned int mem_max, unsigned int seed)
+  : BasicMicroSAT<Policy>(nVars, mem_max)
+  {
+    if (seed == 0)
+      return;
+
+    // xorshift32 PRNG, must not be zero
+    unsigned int x = seed * 2654435761U;
+    if (x == 0)
+      x = 1;
+
+    // shuffle decision order (Fisher-Yates)
+    int numVars = this->m_nVars;
+    std::vector<int> order(numVars + 1);
+    for (int i = 0; i <= numVars; i++)
+      order[i] = i;
+    for (int i = numVars; i > 1; i--)
+    {
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      std::swap(order[i], order[1 + x % i]);
+    }
+
+    // rebuild the double-linked list, order[0] is the stop-marker
+    for (int i = 1; i <= numVars; i++)
+    {
+      this->m_prev[order[i]]     = order[i - 1];
+      this->m_next[order[i - 1]] = order[i];
+    }
+    this->m_next[order[numVars]] = 0;
+    this->m_head = order[numVars];
+
+    // random initial phases for every other solver
+    if (seed % 2 == 1)
+      for (int i = 1; i <= numVars; i++)
+      {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        this->setPhase(i, (x & 1) != 0);
+      }
+  }
+};
+
+
+// lock-free ring buffer of short lemmas: multiple writers, each reader keeps its own position
+class LemmaExchange
+{
+public:
+  enum { MaxSize = 8, MaxLBD = 3 }; // share only lemmas with at most 8 literals and an LBD of at most 3
+  enum { NumSlots = 1 << 12 };      // older lemmas are overwritten
+
+  LemmaExchange()
+  : m_slots(new Slot[NumSlots]()),
+    m_next(0)
+  {}
+
+  ~LemmaExchange()
+  {
+    delete[] m_slots;
+  }
+
+  // publish a lemma, silently dropped if too long or if another writer is busy with the same slot
+  void publish(unsigned int source, const int* lemma, unsigned int size, unsigned int lbd)
+  {
+    if (size > MaxSize || lbd > MaxLBD)
+      return;
+
+    // sequence number is odd while writing, even when done
+    unsigned long long id = m_next.fetch_add(1);
+    Slot& slot = m_slots[id % NumSlots];
+    unsigned long long sequence = slot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) != 0 || !slot.sequence.compare_exchange_strong(sequence, 2 * id + 1, std::memory_order_acquire))
+      return;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.source.store(source,                                std::memory_order_relaxed);
+    slot.size  .store(size,                                  std::memory_order_relaxed);
+    slot.lbd   .store(lbd,                                   std::memory_order_relaxed);
+    for (unsigned int i = 0; i < size; i++)
+      slot.literals[i].store(lemma[i],                       std::memory_order_relaxed);
+    slot.sequence.store(2 * id + 2,                          std::memory_order_release);
+  }
+
+  // fetch the next lemma of any other solver, return false if there is none
+  // position is the reader's state, starts at zero
+  bool fetch(unsigned int reader, unsigned long long& position, std::vector<int>& lemma, unsigned int& lbd) const
+  {
+    unsigned long long last = m_next.load(std::memory_order_acquire);
+    // skip lemmas which were already overwritten
+    if (last - position > NumSlots)
+      position = last - NumSlots;
+
+    for (; position < last; position++)
+    {
+      const Slot& slot = m_slots[position % NumSlots];
+      unsigned long long sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence != 2 * position + 2)
+        continue; // still being written or already overwritten
+
+      unsigned int source = slot.source.load(std::memory_order_relaxed);
+      unsigned int size   = slot.size  .load(std::memory_order_relaxed);
+      lbd                 = slot.lbd   .load(std::memory_order_relaxed);
+      lemma.resize(size);
+      for (unsigned int i = 0; i < size; i++)
+        lemma[i] = slot.literals[i].load(std::memory_order_relaxed);
+
+      // discard if modified while reading
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != sequence || source == reader)
+        continue;
+
+      position++;
+      return true;
+    }
+    return false;
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<unsigned long long> sequence;
+    std::atomic<unsigned int>       source;
+    std::atomic<unsigned int>       size;
+    std::atomic<unsigned int>       lbd;
+    std::atomic<int>                literals[MaxSize];
+  };
+
+  Slot*                           m_slots; // ring buffer
+  std::atomic<unsigned long long> m_next;  // number of lemmas ever published
+
+  // disable copying
+  LemmaExchange(const LemmaExchange&);
+  LemmaExchange& operator=(const LemmaExchange&);
+};
+
+
+// run multiple solvers in parallel, compatible with microsat-cpp
+class ParallelMicroSAT
+{
+  // restart strategies of the solvers
+  struct LubyPolicy  : MicroSATPolicy { static const RestartStrategy Restarts = LubyRestarts; };
+  struct EagerPolicy : MicroSATPolicy { enum { RestartMargin = 72 }; };
+
+  // common interface of all solvers (they have different types because of their policies)
+  class Worker
+  {
+  public:
+    virtual ~Worker() {}
+    virtual bool add(const int* in, unsigned int size) = 0;
+    virtual bool add(const std::vector<int>& clause) = 0;
+    virtual int  newVar() = 0;
+    virtual void solve(const int* assumptions, unsigned int size) = 0;
+    virtual int  getStatus() const = 0;
+    virtual bool query(unsigned int var) const = 0;
+    virtual bool failed(int lit) const = 0;
+  };
+
+  template <typename Policy>
+  class WorkerImpl : public Worker
+  {
+    DiversifiedMicroSAT<Policy> m_solver;
+    unsigned int       m_id;       // index of this solver
+    LemmaExchange*     m_exchange; // shared by all solvers
+    unsigned long long m_position; // next lemma to import
+    std::vector<int>   m_lemma;    // last imported lemma
+
+    // callbacks of m_solver
+    static void exportLemma(void* state, const int* lemma, unsigned int size, unsigned int lbd)
+    {
+      WorkerImpl* self = (WorkerImpl*) state;
+      self->m_exchange->publish(self->m_id, lemma, size, lbd);
+    }
+    static const int* importLemma(void* state, unsigned int* size, unsigned int* lbd)
+    {
+      WorkerImpl* self = (WorkerImpl*) state;
+      if (!self->m_exchange->fetch(self->m_id, self->m_position, self->m_lemma, *lbd))
+        return 0;
+      *size = (unsigned int) self->m_lemma.size();
+      return self->m_lemma.data();
+    }
+
+  public:
+    WorkerImpl(unsigned int nVars, unsigned int mem_max, unsigned int seed, std::atomic<bool>* stop, LemmaExchange* exchange)
+    : m_solver(nVars, mem_max, seed),
+      m_id(seed),
+      m_exchange(exchange),
+      m_position(0),
+      m_lemma()
+    {
+      m_solver.setTerminate(stop, &ParallelMicroSAT::isStopped);
+      m_solver.setLemmaExport(this, &exportLemma);
+      m_solver.setLemmaImport(this, &importLemma);
+    }
+    bool add(const int* in, unsigned int size)         { return m_solver.add(in, size); }
+    bool add(const std::vector<int>& clause)           { return m_solver.add(clause); }
+    int  newVar()                                      { return m_solver.newVar(); }
+    void solve(const int* assumptions, unsigned int size) { m_solver.solve(assumptions, size); }
+    int  getStatus() const                             { return m_solver.getStatus(); }
+    bool query(unsigned int var) const                 { return m_solver.query(var); }
+    bool failed(int lit) const                         { return m_solver.failed(lit); }
+  };
+
+  LemmaExchange        m_exchange; // shared lemmas
+  std::vector<Worker*> m_workers;  // all solvers
+  std::atomic<bool>    m_stop;     // true if a solver found an answer (or failed)
+  int                  m_winner;   // index of the solver which found the answer, -1 if none
+  int                  m_status;   // result of the last call of solve()
+
+  // terminate callback of all solvers
+  static int isStopped(void* state) { return ((std::atomic<bool>*) state)->load() ? 1 : 0; }
+
+  // disable copying
+  ParallelMicroSAT(const ParallelMicroSAT&);
+  ParallelMicroSAT& operator=(const ParallelMicroSAT&);
+
+public:
+  // initialize all solvers, numThreads = 0 => one solver per core
+  explicit ParallelMicroSAT(unsigned int nVars, unsigned int mem_max = 1 << 20, unsigned int numThreads = 0)
+  : m_exchange(),
+    m_workers(),
+    m_stop(false),
+    m_winner(-1),
+    m_status(MicroSAT::UNKNOWN)
+  {
+    if (numThreads == 0)
+      numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+      numThreads = 1;
+
+    // cycle through all restart strategies
+    for (unsigned int i = 0; i < numThreads; i++)
+      switch (i % 3)
+      {
+      case 0:  m_workers.push_back(new WorkerImpl<MicroSATPolicy>(nVars, mem_max, i, &m_stop, &m_exchange)); break;
+      case 1:  m_workers.push_back(new WorkerImpl<LubyPolicy>    (nVars, mem_max, i, &m_stop, &m_exchange)); break;
+      default: m_workers.push_back(new WorkerImpl<EagerPolicy>   (nVars, mem_max, i, &m_stop, &m_exchange)); break;
+      }
+  }
+
+  // deallocate memory
+  virtual ~ParallelMicroSAT()
+  {
+    for (size_t i = 0; i < m_workers.size(); i++)
+      delete m_workers[i];
+  }
+
+  // add a unit
+  bool add(int var) { return add(&var, 1); }
+
+  // define a clause, it is copied to all solvers
+  bool add(const int* in, unsigned int size)
+  {
+    bool result = true;
+    for (size_t i = 0; i < m_workers.size(); i++)
+      result &= m_workers[i]->add(in, size);
+    return result;
+  }
+
+  // same as above, but a convenience function for STL containers
+  template <typename Container>
+  bool add(const Container& v)
+  {
+    std::vector<int> clause(v.begin(), v.end());
+    bool result = true;
+    for (size_t i = 0; i < m_workers.size(); i++)
+      result &= m_workers[i]->add(clause);
+    return result;
+  }
+
+  // add a variable to all solvers and return its number
+  int newVar()
+  {
+    int var = 0;
+    for (size_t i = 0; i < m_workers.size(); i++)
+      var = m_workers[i]->newVar();
+    return var;
+  }
+
+  // determine satisfiability, optionally under temporary assumptions
+  bool solve(const int* assumptions = 0, unsigned int size = 0)
+  {
+    m_stop   = false;
+    m_winner = -1;
+    m_status = MicroSAT::UNKNOWN;
+
+    // run all solvers, the first one with an answer stops all others
+    std::atomic<int> winner(-1);
+    const char* error = 0;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < m_workers.size(); i++)
+      threads.push_back(std::thread([this, i, assumptions, size, &winner, &error]()
+      {
+        try
+        {
+          m_workers[i]->solve(assumptions, size);
+          int none = -1;
+          if (m_workers[i]->getStatus() != MicroSAT::UNKNOWN && winner.compare_exchange_strong(none, (int)i))
+            m_stop = true;
+        }
+        catch (const char* e)
+        {
+          // e.g. out of memory: give up
+          int none = -1;
+          if (winner.compare_exchange_strong(none, -2))
+            error = e;
+          m_stop = true;
+        }
+      }));
+    for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+
+    if (winner == -2)
+      throw error;
+
+    // no winner if all solvers gave up
+    m_winner = winner;
+    m_status = m_winner >= 0 ? m_workers[m_winner]->getStatus() : MicroSAT::UNKNOWN;
+    return m_status == MicroSAT::SATISFIABLE;
+  }
+
+  // same as above, but a convenience function for STL containers
+  template <typename Container>
+  bool solve(const Container& assumptions)
+  {
+    std::vector<int> plain(assumptions.begin(), assumptions.end());
+    return solve(plain.data(), (unsigned int) plain.size());
+  }
+
+  // result of the last call of solve()
+  MicroSAT::Status getStatus() const { return (MicroSAT::Status) m_status; }
+
+  // return solution of a single variable (found by the fastest solver)
+  bool query(unsigned int var) const { return m_winner >= 0 ? m_workers[m_winner]->query(var) : false; }
+
+  // true if assumption lit was needed to prove unsatisfiability (found by the fastest solver)
+  bool failed(int lit) const { return m_winner >= 0 ? m_workers[m_winner]->failed(lit) : false; }
+
+  // number of solvers running in parallel
+  unsigned int getNumThreads() const { return (unsigned int) m_workers.size(); }
+};
+
+
+// solve many independent problems on multiple threads, each thread re-uses its solver's memory
+class BatchMicroSAT
+{
+  // remaining problems of a thread: a range [first, last) packed into a single integer,
+  // the owner takes problems from the front, thieves take the back half
+  struct Range
+  {
+    std::atomic<unsigned long long> packed;
+    Range() : packed(0) {}
+  };
+
+  static unsigned long long pack(unsigned int first, unsigned int last) { return ((unsigned long long) last << 32) | first; }
+
+  std::vector<MicroSAT*> m_solvers; // one per thread
+
+  // load a problem into a solver (re-using its memory) and solve it
+  template <typename Problem>
+  static MicroSAT::Status solveOne(MicroSAT& solver, const Problem& problem)
+  {
+    // count variables
+    unsigned int numVars = 0;
+    for (typename Problem::const_iterator clause = problem.begin(); clause != problem.end(); clause++)
+      for (typename Problem::value_type::const_iterator l = clause->begin(); l != clause->end(); l++)
+      {
+        unsigned int var = (unsigned int) (*l >= 0 ? *l : -*l);
+        if (numVars < var)
+          numVars = var;
+      }
+
+    solver.reset(numVars);
+    for (typename Problem::const_iterator clause = problem.begin(); clause != problem.end(); clause++)
+      solver.add(*clause);
+    solver.solve();
+    return solver.getStatus();
+  }
+
+  // disable copying
+  BatchMicroSAT(const BatchMicroSAT&);
+  BatchMicroSAT& operator=(const BatchMicroSAT&);
+
+public:
+  // numThreads = 0 => one thread per core, mem_max is the initial size of each solver's clause database
+  explicit BatchMicroSAT(unsigned int numThreads = 0, unsigned int mem_max = 1 << 20)
+  : m_solvers()
+  {
+    if (numThreads == 0)
+      numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+      numThreads = 1;
+
+    // the next problem's reset() discards all lemmas anyway: skip solve()'s retention pass
+    for (unsigned int i = 0; i < numThreads; i++)
+    {
+      m_solvers.push_back(new MicroSAT(1, mem_max));
+      m_solvers.back()->setLemmaRetention(100);
+    }
+  }
+
+  // deallocate memory
+  virtual ~BatchMicroSAT()
+  {
+    for (size_t i = 0; i < m_solvers.size(); i++)
+      delete m_solvers[i];
+  }
+
+  // solve all problems in [first, last), each problem is a container of clauses (each clause is a container of ints)
+  // the number of variables of each problem is its highest variable
+  // callback(index, solver) is invoked by a worker thread after each problem was solved (e.g. to query its model)
+  // return status of each problem
+  template <typename Iterator, typename Callback>
+  std::vector<MicroSAT::Status> solve(Iterator first, Iterator last, Callback callback)
+  {
+    unsigned int numProblems = (unsigned int) (last - first);
+    std::vector<MicroSAT::Status> result(numProblems, MicroSAT::UNKNOWN);
+    if (numProblems == 0)
+      return result;
+
+    // split evenly
+    unsigned int numThreads = (unsigned int) m_solvers.size();
+    if (numThreads > numProblems)
+      numThreads = numProblems;
+    std::vector<Range> ranges(numThreads);
+    for (unsigned int i = 0; i < numThreads; i++)
+      ranges[i].packed = pack((unsigned int) ((unsigned long long) numProblems *  i      / numThreads),
+                              (unsigned int) ((unsigned long long) numProblems * (i + 1) / numThreads));
+
+    std::atomic<bool> failed(false);
+    const char* error = 0;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numThreads; i++)
+      threads.push_back(std::thread([this, i, numThreads, first, &ranges, &result, &callback, &failed, &error]()
+      {
+        MicroSAT& solver = *m_solvers[i];
+        Range& own = ranges[i];
+        while (!failed)
+        {
+          // take the next problem of my own range
+          unsigned long long current = own.packed.load();
+          unsigned int next = (unsigned int) current, end = (unsigned int) (current >> 32);
+          if (next >= end)
+          {
+            // empty: steal the back half of another thread's problems
+            bool stolen = false;
+            for (unsigned int j = 1; j < numThreads && !stolen; j++)
+            {
+              Range& victim = ranges[(i + j) % numThreads];
+              unsigned long long theirs = victim.packed.load();
+              unsigned int begin = (unsigned int) theirs, stop = (unsigned int) (theirs >> 32);
+              if (stop - begin < 2)
+                continue; // the owner is about to take its last problem
+              unsigned int middle = begin + (stop - begin) / 2;
+              if (victim.packed.compare_exchange_strong(theirs, pack(begin, middle)))
+              {
+                // nobody steals from an empty range, therefore no CAS needed
+                own.packed = pack(middle, stop);
+                stolen = true;
+              }
+            }
+            if (!stolen)
+              break; // all done
+            continue;
+          }
+          if (!own.packed.compare_exchange_strong(current, pack(next + 1, end)))
+            continue; // a thief was faster
+
+          try
+          {
+            result[next] = solveOne(solver, *(first + next));
+            callback((size_t) next, (const MicroSAT&) solver);
+          }
+          catch (const char* e)
+          {
+            // e.g. out of memory: give up
+            bool none = false;
+            if (failed.compare_exchange_strong(none, true))
+              error = e;
+          }
+        }
+      }));
+    for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+
+    if (failed)
+      throw error;
+    return result;
+  }
+
+  // same as above, without a callback
+  template <typename Iterator>
+  std::vector<MicroSAT::Status> solve(Iterator first, Iterator last)
+  {
+    return solve(first, last, [](size_t, const MicroSAT&) {});
+  }
+
+  // number of threads
+  unsigned int getNumThreads() const { return (unsigned int) m_solvers.size(); }
+};
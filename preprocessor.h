@@ -0,0 +1,530 @@
+#pragma once
+
+/*****************************************************************[preprocessor.h]***
+
+  The MIT License
+
+  Copyright (c) 2020 Stephan Brumme
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*************************************************************************************
+
+  This a wrapper for microsat-cpp which simplifies all clauses before they are sent to the solver.
+  It has the same API as microsat-cpp (except for enumerate and setLemmaRetention).
+
+  code example:
+    Preprocessor s(numVars);                                       // set number of variables
+    s.add(...);                                                    // add clauses (or CnfParser::parse)
+    s.freeze(5);                                                   // optional: variable 5 is used later on
+    if (s.solve()) std::cout << s.query(1);                        // simplify, solve and query as usual
+
+  The first call of solve() runs these steps:
+  - remove duplicate literals and tautologies
+  - unit propagation (top level)
+  - remove subsumed clauses and strengthen clauses by self-subsuming resolution
+  - bounded variable elimination: replace all clauses of a variable by their resolvents if that doesn't
+    increase the number of clauses (variables with many occurrences are skipped)
+  Eliminated variables are reconstructed after each satisfiable call of solve(), therefore query() returns a valid model.
+
+  Note: adding clauses or assumptions with eliminated variables after the first call of solve() is allowed,
+        those variables are re-introduced (their original clauses are sent to the solver).
+        Frozen variables and variables of the first call's assumptions are never eliminated.
+*/
+
+#include "microsat-cpp.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// simplify clauses and send them to microsat-cpp
+class Preprocessor
+{
+public:
+  // skip variables with more occurrences (per polarity) and resolvents with more literals
+  enum { MaxOccurrences = 16, MaxResolventSize = 24 };
+
+  // initialize data structures, mem_max is the initial size of the solver's clause database
+  explicit Preprocessor(unsigned int nVars, unsigned int mem_max = 1 << 20)
+  : m_solver(nVars, mem_max),
+    m_nVars(nVars),
+    m_clauses(),
+    m_removed(),
+    m_signatures(),
+    m_occurrences(2 * nVars + 1),
+    m_value(nVars + 1, 0),
+    m_units(),
+    m_marks(2 * nVars + 1, 0),
+    m_resolvent(),
+    m_frozen(nVars + 1, false),
+    m_eliminated(nVars + 1, -1),
+    m_stack(),
+    m_model(nVars + 1, false),
+    m_done(false),
+    m_unsatisfiable(false),
+    m_nEliminated(0)
+  {}
+
+  // set a unit
+  bool add(int var) { return add(&var, 1); }
+
+  // define a clause
+  bool add(const int* in, unsigned int size)
+  {
+    if (in == 0 || size == 0)
+      return false;
+    for (unsigned int i = 0; i < size; i++)
+      if (in[i] == 0 || in[i] > (int)m_nVars || -in[i] > (int)m_nVars)
+        return false;
+
+    // already preprocessed: forward to solver
+    if (m_done)
+    {
+      for (unsigned int i = 0; i < size; i++)
+        restore(in[i]);
+      return m_solver.add(in, size);
+    }
+
+    std::vector<int> clause(in, in + size);
+    if (normalize(clause))
+      store(clause);
+    return true;
+  }
+
+  // same as above, but a convenience function for STL containers
+  template <typename Container>
+  bool add(const Container& v)
+  {
+    std::vector<int> clause(v.begin(), v.end());
+    return add(clause.data(), (unsigned int) clause.size());
+  }
+
+  // never eliminate var (e.g. because it's used later on)
+  void freeze(unsigned int var)
+  {
+    if (var > 0 && var <= m_nVars)
+      m_frozen[var] = true;
+  }
+
+  // determine satisfiability, optionally under temporary assumptions (simplify during the first call)
+  bool solve(const int* assumptions = 0, unsigned int size = 0)
+  {
+    if (!m_done)
+    {
+      for (unsigned int i = 0; i < size; i++)
+        freeze((unsigned int) (assumptions[i] >= 0 ? assumptions[i] : -assumptions[i]));
+      preprocess();
+    }
+    else
+      for (unsigned int i = 0; i < size; i++)
+        restore(assumptions[i]);
+
+    if (m_unsatisfiable)
+      return false;
+    bool result = m_solver.solve(assumptions, size);
+    if (result)
+      reconstruct();
+    return result;
+  }
+
+  // same as above, but a convenience function for STL containers
+  template <typename Container>
+  bool solve(const Container& assumptions)
+  {
+    std::vector<int> plain(assumptions.begin(), assumptions.end());
+    return solve(plain.data(), (unsigned int) plain.size());
+  }
+
+  // result of the last call of solve()
+  MicroSAT::Status getStatus() const { return m_unsatisfiable ? MicroSAT::UNSATISFIABLE : m_solver.getStatus(); }
+
+  // return solution of a single variable
+  bool query(unsigned int var) const { return var > 0 && var <= m_nVars ? m_model[var] : false; }
+
+  // number of variables
+  unsigned int getNumVars()       const { return m_nVars; }
+  // number of eliminated variables
+  unsigned int getNumEliminated() const { return m_nEliminated; }
+
+private:
+  typedef std::vector<int> Clause;
+
+  // clauses of an eliminated variable, needed for model reconstruction
+  struct Elimination
+  {
+    int var;                     // zero if re-introduced
+    std::vector<Clause> clauses; // all clauses containing the variable
+  };
+
+  MicroSAT m_solver;                              // solves the simplified problem
+  unsigned int m_nVars;                           // number of variables
+  std::vector<Clause> m_clauses;                  // all clauses (only until preprocessing is done)
+  std::vector<char>   m_removed;                  // non-zero if a clause was removed
+  std::vector<unsigned long long> m_signatures;   // one bit per variable (modulo 64) of each clause
+  std::vector<std::vector<unsigned int> > m_occurrences; // clauses containing a literal (index: literal + m_nVars),
+                                                  // may contain removed clauses, too
+  std::vector<signed char> m_value;               // top level assignment: +1 = true, -1 = false, 0 = unassigned
+  std::vector<int>    m_units;                    // units which are not propagated yet
+  std::vector<char>   m_marks;                    // temporary marks per literal (index: literal + m_nVars)
+  Clause              m_resolvent;                // temporary resolvent
+  std::vector<bool>   m_frozen;                   // true if a variable must not be eliminated
+  std::vector<int>    m_eliminated;               // position on m_stack if eliminated, else -1
+  std::vector<Elimination> m_stack;               // eliminated variables in the order of their elimination
+  std::vector<bool>   m_model;                    // model of the last satisfiable call of solve()
+  bool m_done;                                    // true after preprocessing
+  bool m_unsatisfiable;                           // true if preprocessing found a conflict
+  unsigned int m_nEliminated;                     // number of eliminated variables
+
+  static int variable(int lit) { return lit >= 0 ? lit : -lit; }
+
+  // order literals by variable, then by sign
+  static bool byVariable(int a, int b) { return variable(a) < variable(b) || (variable(a) == variable(b) && a < b); }
+
+  std::vector<unsigned int>& occurrences(int lit) { return m_occurrences[lit + (int)m_nVars]; }
+  char& mark(int lit) { return m_marks[lit + (int)m_nVars]; }
+
+  int value(int lit) const { return lit > 0 ? m_value[lit] : -m_value[-lit]; }
+
+  // sort literals and remove duplicates, return false for tautologies
+  static bool normalize(Clause& clause)
+  {
+    std::sort(clause.begin(), clause.end(), byVariable);
+    clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+    for (size_t i = 1; i < clause.size(); i++)
+      if (clause[i] == -clause[i - 1])
+        return false;
+    return true;
+  }
+
+  // bit mask of all variables of a clause (modulo 64), a subset's signature is a subset of the signature
+  // (never zero for a non-empty clause)
+  static unsigned long long signature(const Clause& clause)
+  {
+    unsigned long long result = 0;
+    for (size_t i = 0; i < clause.size(); i++)
+      result |= 1ULL << (variable(clause[i]) % 64);
+    return result;
+  }
+
+  // add a normalized clause to the database
+  void store(const Clause& clause)
+  {
+    if (clause.empty())
+    {
+      m_unsatisfiable = true;
+      return;
+    }
+    if (clause.size() == 1)
+      assignUnit(clause[0]);
+    unsigned int id = (unsigned int) m_clauses.size();
+    m_clauses.push_back(clause);
+    m_removed.push_back(false);
+    m_signatures.push_back(signature(clause));
+    for (size_t i = 0; i < clause.size(); i++)
+      occurrences(clause[i]).push_back(id);
+  }
+
+  void removeClause(unsigned int id)
+  {
+    m_removed[id] = true;
+    m_signatures[id] = 0; // isSubset(..., id, ...) always fails
+    Clause().swap(m_clauses[id]);
+  }
+
+  // remove lit from a clause
+  void strengthen(unsigned int id, int lit)
+  {
+    Clause& clause = m_clauses[id];
+    clause.erase(std::find(clause.begin(), clause.end(), lit));
+    m_signatures[id] = signature(clause);
+    std::vector<unsigned int>& list = occurrences(lit);
+    list.erase(std::find(list.begin(), list.end(), id));
+    if (clause.empty())
+      m_unsatisfiable = true;
+    if (clause.size() == 1)
+      assignUnit(clause[0]);
+  }
+
+  // drop removed clauses from an occurrence list
+  std::vector<unsigned int>& clean(int lit)
+  {
+    std::vector<unsigned int>& list = occurrences(lit);
+    size_t kept = 0;
+    for (size_t i = 0; i < list.size(); i++)
+      if (!m_removed[list[i]])
+        list[kept++] = list[i];
+    list.resize(kept);
+    return list;
+  }
+
+  // assign a top level unit
+  void assignUnit(int lit)
+  {
+    if (value(lit) < 0)
+      m_unsatisfiable = true;
+    if (value(lit) != 0)
+      return;
+    m_value[variable(lit)] = lit > 0 ? +1 : -1;
+    m_units.push_back(lit);
+  }
+
+  // remove satisfied clauses and false literals
+  void propagate()
+  {
+    while (!m_units.empty() && !m_unsatisfiable)
+    {
+      int lit = m_units.back();
+      m_units.pop_back();
+
+      std::vector<unsigned int> satisfied = clean(lit);
+      for (size_t i = 0; i < satisfied.size(); i++)
+        removeClause(satisfied[i]);
+      std::vector<unsigned int> falsified = clean(-lit);
+      for (size_t i = 0; i < falsified.size() && !m_unsatisfiable; i++)
+        strengthen(falsified[i], -lit);
+      occurrences(+lit).clear();
+    }
+  }
+
+  // true if all literals of clause small are in clause large (where one literal of small may be negated)
+  bool isSubset(unsigned int small, unsigned int large, int negated)
+  {
+    if ((m_signatures[small] & ~m_signatures[large]) != 0)
+      return false;
+    return isSubset(m_clauses[small], m_clauses[large], negated);
+  }
+
+  // same as above, but compare literals without checking signatures first
+  bool isSubset(const Clause& small, const Clause& large, int negated)
+  {
+    if (small.size() > large.size())
+      return false;
+    for (size_t i = 0; i < large.size(); i++)
+      mark(large[i]) = 1;
+    bool result = true;
+    for (size_t i = 0; i < small.size() && result; i++)
+      result = mark(small[i] == negated ? -negated : small[i]) != 0;
+    for (size_t i = 0; i < large.size(); i++)
+      mark(large[i]) = 0;
+    return result;
+  }
+
+  // remove all clauses subsumed by clause id and strengthen clauses by self-subsuming resolution
+  void subsume(unsigned int id)
+  {
+    const Clause& clause = m_clauses[id]; // never modified here
+
+    // subsumed clauses must contain the literal with the fewest occurrences
+    // note: occurrence lists aren't cleaned, signatures of removed clauses are zero
+    int rarest = clause[0];
+    size_t fewest = occurrences(rarest).size();
+    for (size_t i = 1; i < clause.size(); i++)
+    {
+      size_t count = occurrences(clause[i]).size();
+      if (fewest > count)
+      {
+        fewest = count;
+        rarest = clause[i];
+      }
+    }
+    const std::vector<unsigned int>& candidates = occurrences(rarest); // removeClause doesn't modify occurrence lists
+    for (size_t i = 0; i < candidates.size(); i++)
+      if (candidates[i] != id && isSubset(id, candidates[i], 0))
+        removeClause(candidates[i]);
+
+    // self-subsuming resolution: if clause = C + lit and other = D + C + -lit then other becomes D + C
+    for (size_t l = 0; l < clause.size() && !m_unsatisfiable; l++)
+    {
+      const std::vector<unsigned int>& others = occurrences(-clause[l]);
+      for (size_t i = 0; i < others.size() && !m_unsatisfiable; )
+        if (isSubset(id, others[i], clause[l]))
+          strengthen(others[i], -clause[l]); // removes others[i] from this list
+        else
+          i++;
+    }
+  }
+
+  // resolve a (contains var) and b (contains -var), return false if the resolvent is a tautology
+  bool resolve(const Clause& a, const Clause& b, int var, Clause& resolvent)
+  {
+    resolvent.clear();
+    for (size_t i = 0; i < a.size(); i++)
+      if (a[i] != var)
+      {
+        mark(a[i]) = 1;
+        resolvent.push_back(a[i]);
+      }
+    bool tautology = false;
+    for (size_t i = 0; i < b.size() && !tautology; i++)
+      if (b[i] != -var)
+      {
+        tautology = mark(-b[i]) != 0;
+        if (!mark(b[i]))
+          resolvent.push_back(b[i]);
+      }
+    for (size_t i = 0; i < a.size(); i++)
+      mark(a[i]) = 0;
+    return !tautology;
+  }
+
+  // try to eliminate var, return true if successful
+  bool eliminate(int var)
+  {
+    const std::vector<unsigned int>& positive = clean(+var);
+    const std::vector<unsigned int>& negative = clean(-var);
+    if (positive.size() > MaxOccurrences || negative.size() > MaxOccurrences)
+      return false;
+    if (positive.empty() && negative.empty())
+      return false; // unused variable
+
+    // count non-tautological resolvents, give up if there are more than clauses or if a resolvent is too long
+    size_t limit = positive.size() + negative.size(), count = 0;
+    for (size_t p = 0; p < positive.size() && count <= limit; p++)
+      for (size_t n = 0; n < negative.size() && count <= limit; n++)
+        if (resolve(m_clauses[positive[p]], m_clauses[negative[n]], var, m_resolvent))
+          count += m_resolvent.size() > MaxResolventSize ? limit + 1 : 1;
+    if (count > limit)
+      return false;
+
+    // move all clauses of var to the reconstruction stack (positive first)
+    m_eliminated[var] = (int) m_stack.size();
+    m_stack.push_back(Elimination());
+    Elimination& elimination = m_stack.back();
+    elimination.var = var;
+    for (size_t i = 0; i < positive.size(); i++)
+      elimination.clauses.push_back(m_clauses[positive[i]]);
+    for (size_t i = 0; i < negative.size(); i++)
+      elimination.clauses.push_back(m_clauses[negative[i]]);
+    size_t numPositive = positive.size();
+    for (size_t i = 0; i < elimination.clauses.size(); i++)
+      removeClause(i < numPositive ? positive[i] : negative[i - numPositive]);
+    m_nEliminated++;
+
+    // and replace them by their resolvents
+    for (size_t p = 0; p < numPositive; p++)
+      for (size_t n = numPositive; n < elimination.clauses.size() && !m_unsatisfiable; n++)
+        if (resolve(elimination.clauses[p], elimination.clauses[n], var, m_resolvent))
+          store(m_resolvent);
+    return true;
+  }
+
+  // simplify all clauses and send them to the solver
+  void preprocess()
+  {
+    m_done = true;
+    propagate();
+
+    // subsumption, shortest clauses first
+    std::vector<std::pair<size_t, unsigned int> > order;
+    for (unsigned int id = 0; id < m_clauses.size(); id++)
+      if (!m_removed[id])
+        order.push_back(std::make_pair(m_clauses[id].size(), id));
+    std::sort(order.begin(), order.end());
+    for (size_t i = 0; i < order.size() && !m_unsatisfiable; i++)
+      if (!m_removed[order[i].second] && !m_clauses[order[i].second].empty())
+      {
+        subsume(order[i].second);
+        propagate();
+      }
+
+    // bounded variable elimination, try variables with few occurrences first
+    std::vector<std::pair<unsigned long long, int> > candidates;
+    for (int var = 1; var <= (int)m_nVars; var++)
+      if (!m_frozen[var] && m_value[var] == 0)
+        candidates.push_back(std::make_pair((unsigned long long) clean(+var).size() * clean(-var).size(), var));
+    std::sort(candidates.begin(), candidates.end());
+    for (size_t i = 0; i < candidates.size() && !m_unsatisfiable; i++)
+      if (m_value[candidates[i].second] == 0)
+      {
+        eliminate(candidates[i].second);
+        propagate();
+      }
+
+    if (m_unsatisfiable)
+      return;
+
+    // send top level units and remaining clauses to the solver
+    for (int var = 1; var <= (int)m_nVars; var++)
+      if (m_value[var] != 0)
+        m_solver.add(m_value[var] > 0 ? +var : -var);
+    for (size_t id = 0; id < m_clauses.size(); id++)
+      if (!m_removed[id])
+        m_solver.add(m_clauses[id].data(), (unsigned int) m_clauses[id].size());
+
+    // release memory
+    std::vector<Clause>().swap(m_clauses);
+    std::vector<char>().swap(m_removed);
+    std::vector<unsigned long long>().swap(m_signatures);
+    std::vector<std::vector<unsigned int> >().swap(m_occurrences);
+    std::vector<char>().swap(m_marks);
+  }
+
+  // re-introduce an eliminated variable (and all eliminated variables of its clauses)
+  void restore(int lit)
+  {
+    int var = variable(lit);
+    if (var == 0 || var > (int)m_nVars || m_eliminated[var] < 0)
+      return;
+
+    std::vector<Clause> clauses;
+    clauses.swap(m_stack[m_eliminated[var]].clauses);
+    m_stack[m_eliminated[var]].var = 0;
+    m_eliminated[var] = -1;
+    m_nEliminated--;
+
+    for (size_t i = 0; i < clauses.size(); i++)
+    {
+      for (size_t j = 0; j < clauses[i].size(); j++)
+        restore(clauses[i][j]);
+      m_solver.add(clauses[i].data(), (unsigned int) clauses[i].size());
+    }
+  }
+
+  // extend the solver's model to all eliminated variables (in reverse order of their elimination)
+  void reconstruct()
+  {
+    for (unsigned int var = 1; var <= m_nVars; var++)
+      m_model[var] = m_solver.query(var);
+
+    for (size_t i = m_stack.size(); i-- > 0; )
+    {
+      int var = m_stack[i].var;
+      if (var == 0)
+        continue;
+
+      // true if any clause containing +var isn't satisfied otherwise
+      bool needed = false;
+      const std::vector<Clause>& clauses = m_stack[i].clauses;
+      for (size_t c = 0; c < clauses.size() && !needed; c++)
+      {
+        bool positive = false, satisfied = false;
+        for (size_t j = 0; j < clauses[c].size(); j++)
+        {
+          int lit = clauses[c][j];
+          if (lit == var)
+            positive = true;
+          else if (variable(lit) != var && m_model[variable(lit)] == (lit > 0))
+            satisfied = true;
+        }
+        needed = positive && !satisfied;
+      }
+      m_model[var] = needed;
+    }
+  }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+/*****************************************************************[simdscan.h]***
+
+  The MIT License
+
+  Copyright (c) 2020 Stephan Brumme
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*************************************************************************************
+
+  A policy for microsat-cpp which speeds up propagation of long clauses (e.g. sums and XORs with 20+ literals):
+  when a watched literal becomes false then the solver looks for another literal which is not false.
+  The default policy checks one literal after another, SimdScanPolicy checks eight literals at once.
+
+  code example:
+    SimdMicroSAT s(nVars);                                      // same as MicroSAT, but with SimdScanPolicy
+    BasicMicroSAT<SimdScanPolicy<Puzzles>> t(nVars);            // or combined with another policy
+
+  x86: AVX2 gathers the labels of eight literals with a single instruction. The CPU is checked at run-time
+       (GCC and CLang, Visual C++ needs /arch:AVX2) so the same binary runs on older CPUs, too.
+  Other CPUs (e.g. ARM, NEON has no gather instruction): eight independent loads and a single branch.
+  The search is exactly the same as with the default policy (always the first literal which is not false).
+  Short clauses are still scanned one literal after another (see LongClauses).
+
+  Note: gathers are slow on many CPUs and the scalar loop usually stops after a few literals,
+        so measure your encodings (e.g. with examples/benchmark.cpp) before switching to SimdScanPolicy.
+  Note: it requires the default layout of the solver's per-variable arrays (PackedVariables = 0).
+*************************************************************************************/
+
+#include "microsat-cpp.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MICROSAT_AVX2_DISPATCH
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#include <intrin.h>
+#define MICROSAT_AVX2
+#endif
+
+
+template <typename Base = MicroSATPolicy>
+struct SimdScanPolicy : Base
+{
+  // clauses with less literals (two of them are watched) aren't worth it
+  enum { LongClauses = 10 };
+
+  // index of the first literal which is not false (or size if all are false)
+  static int scan(const char* falses, const int* lits, int size)
+  {
+#ifdef MICROSAT_AVX2_DISPATCH
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+      return scanAvx2(falses, lits, size);
+#endif
+#ifdef MICROSAT_AVX2
+    return scanAvx2(falses, lits, size);
+#else
+    return scanBlocks(falses, lits, size);
+#endif
+  }
+
+private:
+  // position of the lowest set bit (mask must not be zero)
+  static int lowestBit(unsigned int mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int) index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+  // portable: eight independent loads and a single branch
+  static int scanBlocks(const char* falses, const int* lits, int size)
+  {
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+      unsigned int isFalse = (falses[lits[i    ]] != 0)      | (falses[lits[i + 1]] != 0) << 1 |
+                             (falses[lits[i + 2]] != 0) << 2 | (falses[lits[i + 3]] != 0) << 3 |
+                             (falses[lits[i + 4]] != 0) << 4 | (falses[lits[i + 5]] != 0) << 5 |
+                             (falses[lits[i + 6]] != 0) << 6 | (falses[lits[i + 7]] != 0) << 7;
+      if (isFalse != 0xFF)
+        return i + lowestBit(~isFalse);
+    }
+    while (i < size && falses[lits[i]])
+      i++;
+    return i;
+  }
+
+#if defined(MICROSAT_AVX2_DISPATCH) || defined(MICROSAT_AVX2)
+  // AVX2: gather 32 bits at each label (the solver reserved 4 bytes after the last one) and keep the lowest byte
+#ifdef MICROSAT_AVX2_DISPATCH
+  __attribute__((target("avx2")))
+#endif
+  static int scanAvx2(const char* falses, const int* lits, int size)
+  {
+    const __m256i lowByte = _mm256_set1_epi32(0xFF);
+    int i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+      __m256i indices = _mm256_loadu_si256((const __m256i*) (lits + i));
+      __m256i labels  = _mm256_and_si256(_mm256_i32gather_epi32((const int*) falses, indices, 1), lowByte);
+      unsigned int notFalse = (unsigned int) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(labels, _mm256_setzero_si256())));
+      if (notFalse != 0)
+        return i + lowestBit(notFalse);
+    }
+    while (i < size && falses[lits[i]])
+      i++;
+    return i;
+  }
+#endif
+};
+
+typedef BasicMicroSAT<SimdScanPolicy<> > SimdMicroSAT;